@@ -0,0 +1,162 @@
+/**
+ * @file ClientPopulation.h
+ * @brief Declares the ClientPopulation class that models a closed-loop set of clients.
+ */
+
+#ifndef CLIENTPOPULATION_H
+#define CLIENTPOPULATION_H
+
+#include "Request.h"
+#include <string>
+#include <vector>
+
+class LoadBalancer;
+
+/**
+ * @class ClientPopulation
+ * @brief Simulates a fixed number of clients that wait for responses, time out, and retry.
+ *
+ * Each client alternates between thinking and having one request outstanding. A request
+ * that is rejected or not completed within the timeout is retried after an exponential
+ * backoff with full jitter, up to a retry limit. Timed-out requests are not withdrawn
+ * from the load balancer, so retries add load exactly when the queue is already deep.
+ *
+ * Offered load counts every request sent, including retries. Goodput counts only
+ * completions that reach a client before its timeout.
+ */
+class ClientPopulation
+{
+public:
+    /**
+     * @brief Constructs a population of idle clients, each with its own source IP.
+     * @param num_clients Number of clients to simulate.
+     * @param think_time Mean number of cycles a client waits between successful requests.
+     * @param timeout Number of cycles a client waits for a response before retrying.
+     * @param max_retries Number of retries before a client gives up on a request.
+     * @param base_backoff Backoff ceiling, in cycles, for the first retry.
+     * @param max_backoff Upper bound, in cycles, on the backoff ceiling.
+     */
+    ClientPopulation(int num_clients, int think_time = 200, int timeout = 100,
+                     int max_retries = 4, int base_backoff = 10, int max_backoff = 640);
+
+    /**
+     * @brief Sends new requests and retries that are due, and times out stale requests.
+     * @param lb The load balancer receiving the requests.
+     * @param now Current simulation time.
+     */
+    void tick(LoadBalancer &lb, int now);
+
+    /**
+     * @brief Notifies the population that a web server finished a request.
+     *
+     * Completions for attempts that already timed out are counted as wasted work.
+     *
+     * @param req The completed request.
+     * @param now Current simulation time.
+     */
+    void onCompletion(const Request &req, int now);
+
+    /**
+     * @brief Gets the number of clients in the population.
+     * @return Number of clients.
+     */
+    int getClientCount();
+
+    /**
+     * @brief Gets the total number of requests sent, including retries.
+     * @return Number of requests offered to the load balancer.
+     */
+    int getSentCount();
+
+    /**
+     * @brief Gets the number of retries sent after a rejection or timeout.
+     * @return Number of retries.
+     */
+    int getRetryCount();
+
+    /**
+     * @brief Gets the number of requests that timed out while outstanding.
+     * @return Number of timeouts.
+     */
+    int getTimeoutCount();
+
+    /**
+     * @brief Gets the number of requests rejected by the load balancer.
+     * @return Number of rejected sends.
+     */
+    int getRejectedCount();
+
+    /**
+     * @brief Gets the number of requests completed before their timeout.
+     * @return Number of useful completions.
+     */
+    int getGoodCount();
+
+    /**
+     * @brief Gets the number of requests completed after the client had stopped waiting.
+     * @return Number of wasted completions.
+     */
+    int getLateCount();
+
+    /**
+     * @brief Gets the number of requests abandoned after exhausting all retries.
+     * @return Number of failed requests.
+     */
+    int getFailedCount();
+
+private:
+    /**
+     * @enum State
+     * @brief What a client is currently doing.
+     */
+    enum State
+    {
+        THINKING,   ///< Idle until next_event, then sends a new request.
+        WAITING,    ///< Has a request outstanding until next_event (its deadline).
+        BACKING_OFF ///< Waiting until next_event before retrying.
+    };
+
+    /**
+     * @struct Client
+     * @brief Per-client state.
+     */
+    struct Client
+    {
+        std::string ip; ///< Source IP address used for every request from this client.
+        State state;    ///< Current state.
+        int next_event; ///< Cycle at which the current state ends.
+        int attempt;    ///< Number of requests sent so far, used to match completions.
+        int retries;    ///< Retries spent on the current request.
+    };
+
+    /**
+     * @brief Sends the client's current request to the load balancer.
+     */
+    void send(int id, LoadBalancer &lb, int now);
+
+    /**
+     * @brief Schedules a retry with backoff, or gives up once max_retries is reached.
+     */
+    void retryOrGiveUp(Client &client, int now);
+
+    /**
+     * @brief Puts the client to sleep for a random think time.
+     */
+    void startThinking(Client &client, int now);
+
+    std::vector<Client> clients; ///< All simulated clients.
+    int think_time;              ///< Mean think time between requests.
+    int timeout;                 ///< Cycles before an outstanding request times out.
+    int max_retries;             ///< Retries allowed per request.
+    int base_backoff;            ///< Backoff ceiling for the first retry.
+    int max_backoff;             ///< Cap on the backoff ceiling.
+    int sent_count;              ///< Requests sent, including retries.
+    int retry_count;             ///< Retries sent.
+    int timeout_count;           ///< Requests that timed out.
+    int rejected_count;          ///< Sends rejected by the load balancer.
+    int good_count;              ///< Completions received before timeout.
+    int late_count;              ///< Completions received after timeout.
+    int failed_count;            ///< Requests abandoned after the last retry.
+};
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file LRUCache.h
+ * @brief Declares the LRUCache class and the CacheConfig settings for per-server caching.
+ */
+
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include "Request.h"
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+/**
+ * @struct CacheConfig
+ * @brief Settings for the cache each web server keeps.
+ *
+ * A capacity of 0 disables caching. Requests are keyed either by their source IP
+ * or by their content key.
+ */
+struct CacheConfig
+{
+    int capacity;      ///< Maximum number of keys each server caches, or 0 to disable caching.
+    double hit_factor; ///< Multiplier applied to every stage of a request that hits the cache.
+    bool by_content;   ///< True to key on Request::content_key, false to key on Request::ip_in.
+
+    /**
+     * @brief Constructs a cache configuration.
+     * @param capacity Maximum number of keys each server caches.
+     * @param hit_factor Multiplier applied to the service time of a cache hit.
+     * @param by_content True to key on content, false to key on source IP.
+     */
+    CacheConfig(int capacity = 0, double hit_factor = 1.0, bool by_content = false)
+        : capacity(capacity), hit_factor(hit_factor), by_content(by_content) {}
+
+    /**
+     * @brief Computes the cache key of a request under this configuration.
+     * @param req The request to key.
+     * @return The request's content key or packed source IP.
+     */
+    uint32_t keyFor(const Request &req) const;
+};
+
+/**
+ * @class LRUCache
+ * @brief A bounded cache of keys that evicts the least recently used key when full.
+ *
+ * Only keys are stored, since the simulation only needs to know whether a request's
+ * data would already be on the server. Keys are kept in recency order in a list,
+ * with a hash map from key to list position for constant-time lookups.
+ */
+class LRUCache
+{
+public:
+    /**
+     * @brief Constructs an empty cache.
+     * @param capacity Maximum number of keys held; 0 makes every access a miss.
+     */
+    LRUCache(int capacity = 0);
+
+    /**
+     * @brief Looks up a key, marking it most recently used and inserting it on a miss.
+     * @param key The key to access.
+     * @return True on a hit, false on a miss.
+     */
+    bool access(uint32_t key);
+
+    /**
+     * @brief Gets the number of accesses that hit.
+     * @return Hit count.
+     */
+    int getHits();
+
+    /**
+     * @brief Gets the number of accesses that missed.
+     * @return Miss count.
+     */
+    int getMisses();
+
+private:
+    int capacity;                 ///< Maximum number of keys held.
+    std::list<uint32_t> recency;  ///< Keys from most to least recently used.
+    std::unordered_map<uint32_t, std::list<uint32_t>::iterator> index; ///< Key to position in recency.
+    int hits;                     ///< Number of hits.
+    int misses;                   ///< Number of misses.
+};
+
+#endif
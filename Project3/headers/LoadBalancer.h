@@ -8,16 +8,46 @@
 
 #include "WebServer.h"
 #include "RequestQueue.h"
+#include "RateLimiter.h"
+#include "StreamingStats.h"
 #include <fstream>
 #include <vector>
 
+class ClientPopulation;
+
+/**
+ * @struct LoadBalancerConfig
+ * @brief Optional LoadBalancer settings. Callers change only the fields they need.
+ */
+struct LoadBalancerConfig
+{
+    int server_concurrency;     ///< Maximum number of requests each server holds at once.
+    CacheConfig cache;          ///< Cache settings given to every web server.
+    bool affinity_routing;      ///< If true, routes each request to the server its cache key hashes to.
+    RateLimitConfig rate_limit; ///< Per-source token-bucket settings; a burst of 0 disables rate limiting.
+
+    /**
+     * @brief Constructs the default configuration: blocking servers, no cache,
+     *        queue-order routing, and the default rate limit.
+     */
+    LoadBalancerConfig() : server_concurrency(1), affinity_routing(false) {}
+};
+
 /**
  * @class LoadBalancer
  * @brief Simulates a load balancer that distributes incoming web requests to multiple web servers.
  *
  * The LoadBalancer manages a queue of incoming requests, a dynamic pool of web servers,
  * and tracks statistics such as rejected requests and processed requests.
+ * Incoming requests first pass a per-source RateLimiter so that a single noisy
+ * client cannot fill the queue on its own.
+ * Requests are dispatched either in queue order to the first server with spare
+ * capacity or, with affinity routing, preferably to the server their cache key
+ * hashes to so that repeated keys land on a warm cache.
  * It supports scaling the number of servers based on the load.
+ * Queue size, busy servers, throughput, and rejections are sampled every cycle
+ * into StreamingStats, so summaries stay cheap and bounded in memory however
+ * long the simulation runs.
  */
 class LoadBalancer
 {
@@ -25,8 +55,9 @@ public:
     /**
      * @brief Constructs a LoadBalancer with a specified number of web servers.
      * @param num_servers The initial number of web servers to create.
+     * @param config Concurrency, cache, routing, and rate-limit settings.
      */
-    LoadBalancer(int num_servers);
+    LoadBalancer(int num_servers, LoadBalancerConfig config = LoadBalancerConfig());
 
     /**
      * @brief Destructor. Cleans up dynamically allocated web servers.
@@ -35,32 +66,56 @@ public:
 
     /**
      * @brief Adds a new request to the request queue.
+     *        If the source has exceeded its rate limit, increments the rate-limited count instead.
      *        If the queue is full, increments rejected request count instead.
      * @param request The Request object to be added.
+     * @return True if the request was queued, false if it was rate limited or rejected.
      */
-    void addRequest(Request request);
+    bool addRequest(Request request);
 
     /**
-     * @brief Assigns queued requests to idle web servers.
+     * @brief Assigns queued requests to web servers with spare concurrency.
+     *        With affinity routing, each server looks a short way into the queue
+     *        for a request whose key maps to it before taking the front request.
      */
     void assignRequests();
 
     /**
      * @brief Advances the simulation by one clock cycle.
-     *        Updates all servers and increments internal time.
+     *        Updates all servers, reports completed requests to the attached
+     *        client population (if any), and increments internal time.
      */
     void tick();
 
     /**
      * @brief Runs the simulation for a given number of clock cycles.
      *        Randomly adds new requests based on request chance.
-     *        Logs status to the provided output stream at intervals.
+     *        Logs status rows every snapshot interval, if enabled, and a statistics summary.
      * @param total_cycles Total number of cycles to simulate.
      * @param request_chance Percentage chance of generating a new request each cycle.
      * @param logfile Output stream to write simulation logs.
      */
     void simulate(int total_cycles, int request_chance, std::ostream &logfile);
 
+    /**
+     * @brief Runs the simulation for a given number of clock cycles with closed-loop clients.
+     *        Requests come only from the client population, which is told about every
+     *        rejection and completion. Logs status rows every snapshot interval, if enabled,
+     *        and a statistics summary.
+     * @param total_cycles Total number of cycles to simulate.
+     * @param population The client population generating requests.
+     * @param logfile Output stream to write simulation logs.
+     */
+    void simulateClosedLoop(int total_cycles, ClientPopulation &population, std::ostream &logfile);
+
+    /**
+     * @brief Sets how often simulate() and simulateClosedLoop() write a status row.
+     *        Rows grow with run length, so they are off by default; the streaming
+     *        statistics and their downsampled series are always written.
+     * @param cycles Cycles between status rows, or 0 to disable them.
+     */
+    void setSnapshotInterval(int cycles);
+
     /**
      * @brief Gets the current size of the request queue.
      * @return Number of requests waiting in the queue.
@@ -80,7 +135,21 @@ public:
     int getBusyServerCount();
 
     /**
-     * @brief Gets the total number of requests processed by all servers.
+     * @brief Counts the requests currently in flight across all servers.
+     * @return Number of assigned, unfinished requests.
+     */
+    int getActiveRequestCount();
+
+    /**
+     * @brief Gets the total number of cycles server CPUs spent on request work,
+     *        including servers that have since been removed by scaling.
+     * @return Total busy CPU cycles.
+     */
+    int getCpuBusyCycles();
+
+    /**
+     * @brief Gets the total number of requests processed by all servers,
+     *        including servers that have since been removed by scaling.
      * @return Total processed request count.
      */
     int getTotalProcessedRequests();
@@ -91,6 +160,60 @@ public:
      */
     int getRejectedRequests();
 
+    /**
+     * @brief Gets the total number of requests rejected by per-source rate limiting.
+     * @return Number of rate-limited requests.
+     */
+    int getRateLimitedRequests();
+
+    /**
+     * @brief Gets the sources with the most rate-limited requests, highest first.
+     * @return Up to RateLimiter::MAX_OFFENDERS offenders.
+     */
+    std::vector<RateLimiter::Offender> getTopRateLimitedSources();
+
+    /**
+     * @brief Gets the number of requests that hit a server cache, including removed servers.
+     * @return Total cache hits.
+     */
+    int getCacheHits();
+
+    /**
+     * @brief Gets the number of requests that missed a server cache, including removed servers.
+     * @return Total cache misses.
+     */
+    int getCacheMisses();
+
+    /**
+     * @brief Calculates the fraction of assigned requests that hit a server cache.
+     * @return Hit rate in [0, 1], or 0 if no request has been assigned.
+     */
+    double getCacheHitRate();
+
+    /**
+     * @brief Gets the per-cycle statistics of the request queue size.
+     * @return Queue size statistics.
+     */
+    const StreamingStats &getQueueStats();
+
+    /**
+     * @brief Gets the per-cycle statistics of the number of busy servers.
+     * @return Busy server statistics.
+     */
+    const StreamingStats &getBusyServerStats();
+
+    /**
+     * @brief Gets the per-cycle statistics of the number of completed requests.
+     * @return Throughput statistics.
+     */
+    const StreamingStats &getThroughputStats();
+
+    /**
+     * @brief Gets the per-cycle statistics of the number of rejected and rate-limited requests.
+     * @return Rejection statistics.
+     */
+    const StreamingStats &getRejectionStats();
+
     /**
      * @brief Calculates how many servers are currently idle (not processing).
      * @return Number of inactive servers.
@@ -103,11 +226,41 @@ public:
      */
     void scaleServers();
 
+    static const int AFFINITY_WINDOW = 32; ///< How far affinity routing looks into the queue.
+
 private:
+    /**
+     * @brief Samples the current cycle's queue size, busy servers, throughput, and rejections.
+     */
+    void recordStats();
+
+    /**
+     * @brief Writes a summary of every metric and its downsampled time series.
+     * @param logfile Output stream to write to.
+     */
+    void logStats(std::ostream &logfile);
+
     std::vector<WebServer *> servers;  ///< Vector holding pointers to the managed web servers.
     RequestQueue requestQueue;          ///< Queue of incoming requests awaiting processing.
+    RateLimiter rateLimiter;            ///< Per-source token buckets applied before queueing.
+    bool rate_limiting;                 ///< Whether rateLimiter is consulted at all.
     int time;                          ///< Simulation clock time.
     int rejected_requests;         ///< Count of requests rejected due to full queue.
+    int server_concurrency;        ///< Concurrency limit given to every new web server.
+    int retired_processed;         ///< Requests processed by servers that were scaled away.
+    CacheConfig cache_config;      ///< Cache settings given to every new web server.
+    bool affinity_routing;         ///< Whether requests are routed by cache key.
+    int retired_cache_hits;        ///< Cache hits on servers that were scaled away.
+    int retired_cache_misses;      ///< Cache misses on servers that were scaled away.
+    int retired_cpu_busy_cycles;   ///< Busy CPU cycles on servers that were scaled away.
+    int completed_last_tick;       ///< Requests completed during the most recent tick.
+    int recorded_rejections;       ///< Rejections already counted by recordStats().
+    int snapshot_interval;         ///< Cycles between logged status rows, or 0 for none.
+    StreamingStats queue_stats;    ///< Queue size per cycle.
+    StreamingStats busy_stats;     ///< Busy servers per cycle.
+    StreamingStats throughput_stats; ///< Completed requests per cycle.
+    StreamingStats rejection_stats;  ///< Rejected and rate-limited requests per cycle.
+    ClientPopulation *clients;     ///< Client population notified of completions, or nullptr.
 };
 
 #endif
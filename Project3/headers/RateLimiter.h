@@ -0,0 +1,153 @@
+/**
+ * @file RateLimiter.h
+ * @brief Declares the RateLimiter class that applies per-source token buckets to incoming requests.
+ */
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct RateLimitConfig
+ * @brief Token-bucket settings for a RateLimiter. A burst of 0 disables rate limiting.
+ */
+struct RateLimitConfig
+{
+    int burst;           ///< Maximum number of requests a source may send back-to-back, or 0 to disable.
+    int refill_interval; ///< Number of cycles needed to earn one token.
+    int idle_timeout;    ///< Number of idle cycles after which a source's bucket is discarded.
+
+    /**
+     * @brief Constructs a rate-limit configuration.
+     * @param burst Maximum number of requests a source may send back-to-back, or 0 to disable.
+     * @param refill_interval Number of cycles needed to earn one token.
+     * @param idle_timeout Number of idle cycles after which a source's bucket is discarded.
+     */
+    RateLimitConfig(int burst = 20, int refill_interval = 10, int idle_timeout = 200)
+        : burst(burst), refill_interval(refill_interval), idle_timeout(idle_timeout) {}
+};
+
+/**
+ * @class RateLimiter
+ * @brief Admission-control stage that throttles each source IPv4 address with its own token bucket.
+ *
+ * Buckets live in an open-addressing hash table keyed on the packed address, using
+ * linear probing over a flat array of 16-byte slots so a lookup usually touches a
+ * single cache line. Tokens are kept in integer "cycle" units: every clock cycle
+ * adds one unit and a request costs refill_interval units, so a source may send
+ * one request per refill_interval cycles with bursts of up to burst requests.
+ *
+ * Buckets that have been idle for idle_timeout cycles are swept out of the table
+ * so memory tracks the number of recently active sources rather than every
+ * address ever seen.
+ */
+class RateLimiter
+{
+public:
+    /**
+     * @struct Offender
+     * @brief A source address and how many of its requests were rate limited.
+     */
+    struct Offender
+    {
+        uint32_t ip; ///< Packed IPv4 address of the source.
+        int limited; ///< Number of requests rejected from this source.
+    };
+
+    /**
+     * @brief Constructs a RateLimiter with the given bucket parameters.
+     * @param burst Maximum number of requests a source may send back-to-back.
+     * @param refill_interval Number of cycles needed to earn one token.
+     * @param idle_timeout Number of idle cycles after which a source's bucket is discarded;
+     *        raised to burst * refill_interval if shorter.
+     */
+    RateLimiter(int burst = 20, int refill_interval = 10, int idle_timeout = 200);
+
+    /**
+     * @brief Charges one token to the given source if it has one available.
+     * @param ip Packed IPv4 address of the source.
+     * @param now Current simulation time.
+     * @return True if the request is admitted, false if it is rate limited.
+     */
+    bool allow(uint32_t ip, int now);
+
+    /**
+     * @brief Removes buckets that have not been touched for idle_timeout cycles.
+     * @param now Current simulation time.
+     */
+    void expireIdle(int now);
+
+    /**
+     * @brief Gets the total number of requests rejected by the limiter.
+     * @return Number of rate-limited requests.
+     */
+    int getLimitedCount();
+
+    /**
+     * @brief Gets the number of sources currently tracked in the table.
+     * @return Number of live buckets.
+     */
+    int getTrackedSourceCount();
+
+    /**
+     * @brief Gets the sources with the most rate-limited requests, highest first.
+     *
+     * Counts are approximate: at most MAX_OFFENDERS sources are remembered, and a
+     * newcomer only displaces the smallest entry once its own count exceeds it.
+     *
+     * @return Up to MAX_OFFENDERS offenders sorted by descending count.
+     */
+    std::vector<Offender> getTopOffenders();
+
+    static const int MAX_OFFENDERS = 5; ///< Number of top offending sources retained.
+
+private:
+    /**
+     * @struct Bucket
+     * @brief One slot of the hash table. A slot is empty when last_seen is negative.
+     */
+    struct Bucket
+    {
+        uint32_t ip;       ///< Packed IPv4 address owning this bucket.
+        int32_t last_seen; ///< Cycle at which the bucket was last refilled.
+        int32_t tokens;    ///< Available tokens, in cycle units.
+        int32_t limited;   ///< Requests limited since the bucket was created.
+    };
+
+    /**
+     * @brief Finds the slot holding ip, or the empty slot where it should be inserted.
+     * @param ip Packed IPv4 address to look up.
+     * @return Index into the table.
+     */
+    uint32_t findSlot(uint32_t ip);
+
+    /**
+     * @brief Rehashes all live buckets into a table of the given capacity.
+     * @param capacity New capacity; must be a power of two.
+     * @param now Current simulation time, used to drop idle buckets.
+     */
+    void rebuild(uint32_t capacity, int now);
+
+    /**
+     * @brief Records one more limited request from ip in the top-offender list.
+     * @param ip Packed IPv4 address of the source.
+     * @param bucket_limited The source's limited count in its current bucket.
+     */
+    void recordOffender(uint32_t ip, int bucket_limited);
+
+    std::vector<Bucket> table;     ///< Open-addressing table of token buckets.
+    std::vector<Bucket> scratch;   ///< Spare storage reused when rebuilding the table.
+    uint32_t mask;                 ///< capacity - 1, used to wrap probe indices.
+    int shift;                     ///< Right shift applied to the multiplicative hash.
+    int live_count;                ///< Number of occupied slots.
+    int max_tokens;                ///< Bucket capacity, in cycle units.
+    int cost;                      ///< Tokens charged per request, in cycle units.
+    int idle_timeout;              ///< Idle cycles before a bucket is discarded.
+    int last_sweep;                ///< Cycle of the most recent idle sweep.
+    int limited_count;             ///< Total requests rejected by the limiter.
+    std::vector<Offender> offenders; ///< Top offending sources, unsorted.
+};
+
+#endif
@@ -6,29 +6,52 @@
 #ifndef REQUEST_H
 #define REQUEST_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
+
+/**
+ * @struct RequestStage
+ * @brief One step of a request: either CPU work on the server or a wait on a backend.
+ */
+struct RequestStage
+{
+    bool io;    ///< True if the stage waits on I/O, false if it needs the server's CPU.
+    int cycles; ///< Number of cycles the stage lasts.
+};
 
 /**
  * @struct Request
  * @brief Represents a web request with input/output IP addresses and processing time.
  *
  * The Request struct holds the information needed by the load balancer and web servers
- * to process a request in the simulation.
+ * to process a request in the simulation. Requests issued by a ClientPopulation also
+ * carry the issuing client and attempt number so completions can be matched back.
+ *
+ * A request with no stages is a single CPU stage lasting time cycles. Otherwise it
+ * runs its stages in order and time is their total.
  */
 struct Request
 {
     std::string ip_in;  ///< The IP address of the requester.
     std::string ip_out; ///< The destination IP address for the response.
     int time;           ///< The amount of time required to process the request.
+    int client_id;      ///< Index of the issuing client, or -1 for open-loop requests.
+    int attempt;        ///< Client-local attempt number, used to ignore stale completions.
+    std::vector<RequestStage> stages; ///< CPU and I/O stages, or empty for a single CPU stage.
+    uint32_t content_key; ///< Identifies the content requested, for server-side caching.
 
     /**
      * @brief Constructs a Request with specified IP addresses and processing time.
      * @param ip_in The input IP address.
      * @param ip_out The output IP address.
      * @param time The time required to process the request.
+     * @param client_id The issuing client, or -1 if the request has none.
+     * @param attempt The client's attempt number for this request.
      */
-    Request(std::string ip_in, std::string ip_out, int time)
-        : ip_in(ip_in), ip_out(ip_out), time(time) {}
+    Request(std::string ip_in, std::string ip_out, int time, int client_id = -1, int attempt = 0)
+        : ip_in(ip_in), ip_out(ip_out), time(time), client_id(client_id), attempt(attempt),
+          content_key(0) {}
 };
 
 #endif
@@ -7,13 +7,15 @@
 #define REQUESTQUEUE_H
 
 #include "Request.h"
-#include <queue>
+#include <deque>
 
 /**
  * @class RequestQueue
- * @brief A wrapper around the standard queue to manage web requests.
+ * @brief A wrapper around a standard deque to manage web requests.
  *
  * Provides enqueue, dequeue, and utility functions for handling a queue of Request objects.
+ * Requests behind the front can also be inspected and removed, so dispatchers may
+ * look a short distance ahead in the queue.
  */
 class RequestQueue
 {
@@ -43,6 +45,22 @@ public:
      */
     Request front();
 
+    /**
+     * @brief Returns the request at the given position without removing it.
+     * @param index Position in the queue, where 0 is the front.
+     * @return The Request at that position.
+     * @throws std::out_of_range if index is not a valid position.
+     */
+    const Request &at(int index);
+
+    /**
+     * @brief Removes and returns the request at the given position.
+     * @param index Position in the queue, where 0 is the front.
+     * @return The removed Request.
+     * @throws std::out_of_range if index is not a valid position.
+     */
+    Request removeAt(int index);
+
     /**
      * @brief Checks whether the queue is empty.
      * @return True if the queue is empty, false otherwise.
@@ -56,7 +74,7 @@ public:
     int size();
 
 private:
-    std::queue<Request> q; ///< The underlying queue storing Request objects.
+    std::deque<Request> q; ///< The underlying queue storing Request objects.
 };
 
 #endif
@@ -0,0 +1,237 @@
+/**
+ * @file StreamingStats.h
+ * @brief Declares bounded-memory online statistics for per-cycle simulation metrics.
+ */
+
+#ifndef STREAMINGSTATS_H
+#define STREAMINGSTATS_H
+
+#include <deque>
+#include <vector>
+
+/**
+ * @struct StatBucket
+ * @brief Summary of a run of samples: count, sum, minimum, and maximum.
+ */
+struct StatBucket
+{
+    long long count; ///< Number of samples summarized.
+    double sum;      ///< Sum of the samples.
+    double min;      ///< Smallest sample.
+    double max;      ///< Largest sample.
+
+    /**
+     * @brief Constructs an empty bucket.
+     */
+    StatBucket();
+
+    /**
+     * @brief Adds one sample to the bucket.
+     * @param x The sample value.
+     */
+    void add(double x);
+
+    /**
+     * @brief Adds every sample summarized by another bucket.
+     * @param other The bucket to merge in.
+     */
+    void merge(const StatBucket &other);
+
+    /**
+     * @brief Calculates the mean of the summarized samples.
+     * @return The mean, or 0 if the bucket is empty.
+     */
+    double mean() const;
+};
+
+/**
+ * @class CountHistogram
+ * @brief Counts how often each non-negative integer value occurs, for exact quantiles of count metrics.
+ *
+ * Every metric sampled by the simulator is a small bounded count (queue size,
+ * busy servers, completions, rejections), so one bin per value gives exact
+ * quantiles that are always ordered. Bins are added only when a larger value
+ * arrives, so memory follows the largest value seen, not the number of samples.
+ */
+class CountHistogram
+{
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    CountHistogram();
+
+    /**
+     * @brief Adds one sample, rounded to the nearest integer; negative samples count as 0.
+     * @param x The sample value.
+     */
+    void add(double x);
+
+    /**
+     * @brief Gets the smallest value with at least a fraction p of the samples at or below it.
+     * @param p Target quantile in (0, 1], e.g. 0.99.
+     * @return The quantile, or 0 if no samples have been added.
+     */
+    double quantile(double p) const;
+
+private:
+    std::vector<long long> bins; ///< Sample count per value; index is the value.
+    long long count;             ///< Number of samples added.
+};
+
+/**
+ * @class StreamingStats
+ * @brief Tracks one metric sample per cycle with memory that does not grow with run length.
+ *
+ * Provides all-time count, min, max, and mean, an exponentially weighted moving
+ * average, statistics over a moving window of the most recent TIER_LENGTH samples,
+ * and exact median, 90th, and 99th percentiles from a CountHistogram, so samples
+ * are expected to be non-negative integer counts.
+ *
+ * Samples are also downsampled into TIER_COUNT tiers. Tier 0 holds individual
+ * samples, tier 1 holds buckets of 1000 samples, and tier 2 holds buckets of
+ * 1000000 samples. Each tier keeps only its most recent TIER_LENGTH buckets, so a
+ * long run can be read back at the finest resolution that still covers it.
+ */
+class StreamingStats
+{
+public:
+    static const int TIER_COUNT = 3;     ///< Number of downsampling tiers.
+    static const int TIER_LENGTH = 1000; ///< Buckets retained per tier, and the moving window size.
+
+    /**
+     * @brief Constructs an empty set of statistics.
+     * @param ewma_alpha Weight given to each new sample in the moving average.
+     */
+    StreamingStats(double ewma_alpha = 0.01);
+
+    /**
+     * @brief Records one sample.
+     * @param x The sample value.
+     */
+    void add(double x);
+
+    /**
+     * @brief Gets the number of samples recorded.
+     * @return Sample count.
+     */
+    long long getCount() const;
+
+    /**
+     * @brief Gets the smallest sample recorded.
+     * @return Minimum, or 0 if empty.
+     */
+    double getMin() const;
+
+    /**
+     * @brief Gets the largest sample recorded.
+     * @return Maximum, or 0 if empty.
+     */
+    double getMax() const;
+
+    /**
+     * @brief Gets the mean of all samples recorded.
+     * @return Mean, or 0 if empty.
+     */
+    double getMean() const;
+
+    /**
+     * @brief Gets the exponentially weighted moving average.
+     * @return EWMA, or 0 if empty.
+     */
+    double getEWMA() const;
+
+    /**
+     * @brief Gets the mean of the most recent TIER_LENGTH samples.
+     * @return Window mean, or 0 if empty.
+     */
+    double getWindowMean() const;
+
+    /**
+     * @brief Gets the smallest of the most recent TIER_LENGTH samples.
+     * @return Window minimum, or 0 if empty.
+     */
+    double getWindowMin() const;
+
+    /**
+     * @brief Gets the largest of the most recent TIER_LENGTH samples.
+     * @return Window maximum, or 0 if empty.
+     */
+    double getWindowMax() const;
+
+    /**
+     * @brief Gets the median of all samples.
+     * @return Median.
+     */
+    double getMedian() const;
+
+    /**
+     * @brief Gets the 90th percentile of all samples.
+     * @return 90th percentile.
+     */
+    double getP90() const;
+
+    /**
+     * @brief Gets the 99th percentile of all samples.
+     * @return 99th percentile.
+     */
+    double getP99() const;
+
+    /**
+     * @brief Gets the number of samples summarized by each bucket of a tier.
+     * @param tier Tier index in [0, TIER_COUNT).
+     * @return Samples per bucket.
+     */
+    static long long getTierResolution(int tier);
+
+    /**
+     * @brief Gets the retained buckets of a tier, oldest first.
+     * @param tier Tier index in [0, TIER_COUNT).
+     * @return Up to TIER_LENGTH closed buckets, followed by the partially filled
+     *         open bucket if it holds any samples.
+     */
+    std::vector<StatBucket> getSeries(int tier) const;
+
+private:
+    /**
+     * @struct Tier
+     * @brief One downsampling level: the bucket being filled and a ring of closed buckets.
+     */
+    struct Tier
+    {
+        StatBucket open;               ///< Bucket currently accumulating samples.
+        std::vector<StatBucket> ring;  ///< Closed buckets, overwritten oldest first.
+        int next;                      ///< Ring slot the next closed bucket goes into.
+    };
+
+    /**
+     * @struct WindowEntry
+     * @brief A sample that may still become the window minimum or maximum.
+     */
+    struct WindowEntry
+    {
+        long long index; ///< Zero-based position of the sample in the stream.
+        double value;    ///< The sample value.
+    };
+
+    /**
+     * @brief Merges a bucket into a tier, closing and cascading it upward when full.
+     */
+    void addToTier(int tier, const StatBucket &bucket);
+
+    /**
+     * @brief Adds a sample to the window extremes and drops samples that left the window.
+     */
+    void addToWindow(long long index, double x);
+
+    StatBucket total;           ///< Summary of every sample.
+    double ewma_alpha;          ///< EWMA smoothing factor.
+    double ewma;                ///< Current EWMA value.
+    double window_sum;          ///< Sum of the samples in tier 0's ring.
+    std::deque<WindowEntry> window_min; ///< Window samples with increasing values; front is the minimum.
+    std::deque<WindowEntry> window_max; ///< Window samples with decreasing values; front is the maximum.
+    CountHistogram histogram;   ///< Sample counts per value, for quantiles.
+    std::vector<Tier> tiers;    ///< Downsampling tiers, finest first.
+};
+
+#endif
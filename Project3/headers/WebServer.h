@@ -7,21 +7,35 @@
 #define WEBSERVER_H
 
 #include "Request.h"
+#include "LRUCache.h"
+#include <vector>
 
 /**
  * @class WebServer
- * @brief Represents a single web server that processes one request at a time.
+ * @brief Represents a single web server that processes requests on one CPU.
  *
  * The WebServer class handles request assignment, processing time tracking,
  * and counting the number of processed requests.
+ *
+ * A server holds up to max_concurrency requests at once. Only one of them uses the
+ * CPU in a given cycle; the others are either waiting on I/O, which progresses in
+ * parallel, or ready for the CPU. A request keeps the CPU until it finishes or
+ * reaches an I/O stage, at which point it is suspended and the next ready request
+ * runs. With a concurrency of 1 the server blocks through I/O waits, matching the
+ * one-request-per-server model.
+ *
+ * If caching is enabled, each assigned request is looked up in the server's LRU
+ * cache, and a hit scales every stage of the request by the configured hit factor.
  */
 class WebServer
 {
 public:
     /**
      * @brief Constructs a WebServer in an idle state.
+     * @param max_concurrency Maximum number of requests the server holds at once.
+     * @param cache_config Cache settings; caching is disabled by default.
      */
-    WebServer();
+    WebServer(int max_concurrency = 1, CacheConfig cache_config = CacheConfig());
 
     /**
      * @brief Checks if the server is currently processing a request.
@@ -29,6 +43,12 @@ public:
      */
     bool isRunning();
 
+    /**
+     * @brief Checks whether the server has room for another request.
+     * @return True if fewer than max_concurrency requests are in flight.
+     */
+    bool canAccept();
+
     /**
      * @brief Assigns a request to the server for processing.
      * @param request The Request to assign.
@@ -38,12 +58,19 @@ public:
     /**
      * @brief Advances the server by one clock cycle.
      *
-     * Decrements the remaining processing time. Marks the server as idle when complete.
+     * Runs one cycle of CPU work and one cycle of every pending I/O wait, moving
+     * requests to their next stage as stages finish. Marks the server as idle when
+     * every request is complete. Clears the list of requests completed during the
+     * previous tick.
      */
     void tick();
 
     /**
      * @brief Gets the current request being processed by the server.
+     *
+     * This is the request holding the CPU, or the oldest request in flight if all are
+     * waiting on I/O, or the most recently assigned request if the server is idle.
+     *
      * @return The current Request assigned to the server.
      */
     Request getCurrRequest();
@@ -54,11 +81,69 @@ public:
      */
     int getProcessedRequestCount();
 
+    /**
+     * @brief Gets the number of requests currently in flight on this server.
+     * @return Number of assigned, unfinished requests.
+     */
+    int getActiveRequestCount();
+
+    /**
+     * @brief Gets the number of cycles in which the server's CPU did work.
+     * @return Count of busy CPU cycles.
+     */
+    int getCpuBusyCycles();
+
+    /**
+     * @brief Gets the number of assigned requests that hit the server's cache.
+     * @return Cache hit count.
+     */
+    int getCacheHits();
+
+    /**
+     * @brief Gets the number of assigned requests that missed the server's cache.
+     * @return Cache miss count.
+     */
+    int getCacheMisses();
+
+    /**
+     * @brief Gets the requests that finished during the most recent tick.
+     * @return Requests completed by the last call to tick().
+     */
+    const std::vector<Request> &getCompletedRequests();
+
 private:
+    /**
+     * @struct Task
+     * @brief A request in flight and its progress through its stages.
+     */
+    struct Task
+    {
+        Request request;   ///< The request being processed.
+        size_t stage;      ///< Index of the current stage.
+        int remaining;     ///< Cycles left in the current stage.
+    };
+
+    /**
+     * @brief Checks whether a task's current stage is an I/O wait.
+     */
+    bool inIO(const Task &task);
+
+    /**
+     * @brief Moves a task past every finished stage.
+     * @return True if the task has no stages left.
+     */
+    bool advance(Task &task);
+
     bool running;         ///< Indicates whether the server is actively processing a request.
-    int time_remaining;   ///< Time remaining to complete the current request.
-    Request curr_request; ///< The current request being processed.
+    int max_concurrency;  ///< Maximum number of requests in flight.
+    std::vector<Task> tasks; ///< Requests in flight, in assignment order.
+    int cpu_task;         ///< Index in tasks of the request holding the CPU, or -1.
+    Request curr_request; ///< The most recently assigned request, reported while idle.
     int processed_count;  ///< Total number of processed requests.
+    int cpu_busy_cycles;  ///< Number of cycles the CPU spent on request work.
+    CacheConfig cache_config; ///< Cache settings.
+    LRUCache cache;       ///< Keys of recently served requests.
+    std::vector<Request> completed; ///< Requests finished during the last tick.
 };
 
 #endif
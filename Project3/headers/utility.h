@@ -7,6 +7,7 @@
 #define UTILITY_H
 
 #include "Request.h"
+#include <cstdint>
 #include <string>
 
 /**
@@ -15,10 +16,36 @@
  */
 std::string generateRandomIP();
 
+/**
+ * @brief Generates a random content key with a skewed popularity distribution.
+ * @return A key identifying the requested content.
+ */
+uint32_t generateRandomContentKey();
+
 /**
  * @brief Generates a random web request with random IPs and processing time.
  * @return A Request object with randomized IP addresses and time.
  */
 Request generateRandomRequest();
 
+/**
+ * @brief Generates a random web request made of a CPU stage, an I/O wait, and a second CPU stage.
+ * @return A Request object with randomized IP addresses and stages.
+ */
+Request generateRandomStagedRequest();
+
+/**
+ * @brief Packs a dotted-quad IPv4 address into a 32-bit integer.
+ * @param ip A string in the format "X.X.X.X".
+ * @return The address in host byte order, or 0 if the string is not a valid IPv4 address.
+ */
+uint32_t packIPv4(const std::string &ip);
+
+/**
+ * @brief Formats a packed 32-bit IPv4 address as a dotted-quad string.
+ * @param ip The packed address.
+ * @return A string in the format "X.X.X.X".
+ */
+std::string unpackIPv4(uint32_t ip);
+
 #endif
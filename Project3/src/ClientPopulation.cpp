@@ -0,0 +1,252 @@
+/**
+ * @file ClientPopulation.cpp
+ * @brief Implements the ClientPopulation class for closed-loop client simulation.
+ */
+
+#include "../headers/ClientPopulation.h"
+#include "../headers/LoadBalancer.h"
+#include "../headers/utility.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+/**
+ * @brief Constructs the population with every client thinking.
+ *
+ * First requests are spread uniformly over the first two think times so the
+ * population does not start with a synchronized burst.
+ *
+ * @param num_clients Number of clients to simulate.
+ * @param think_time Mean number of cycles a client waits between successful requests.
+ * @param timeout Number of cycles a client waits for a response before retrying.
+ * @param max_retries Number of retries before a client gives up on a request.
+ * @param base_backoff Backoff ceiling, in cycles, for the first retry.
+ * @param max_backoff Upper bound, in cycles, on the backoff ceiling.
+ */
+ClientPopulation::ClientPopulation(int num_clients, int think_time, int timeout,
+                                   int max_retries, int base_backoff, int max_backoff)
+    : think_time(think_time), timeout(timeout), max_retries(max_retries),
+      base_backoff(base_backoff), max_backoff(max_backoff),
+      sent_count(0), retry_count(0), timeout_count(0), rejected_count(0),
+      good_count(0), late_count(0), failed_count(0)
+{
+    for (int i = 0; i < num_clients; ++i)
+    {
+        Client client;
+        client.ip = generateRandomIP();
+        client.attempt = 0;
+        client.retries = 0;
+        startThinking(client, 0);
+        clients.push_back(client);
+    }
+}
+
+/**
+ * @brief Advances every client by one cycle.
+ *
+ * Thinking clients whose think time has elapsed send a new request, backing-off
+ * clients send their retry, and waiting clients past their deadline time out.
+ *
+ * @param lb The load balancer receiving the requests.
+ * @param now Current simulation time.
+ */
+void ClientPopulation::tick(LoadBalancer &lb, int now)
+{
+    for (size_t id = 0; id < clients.size(); ++id)
+    {
+        Client &client = clients[id];
+        if (now < client.next_event)
+        {
+            continue;
+        }
+
+        switch (client.state)
+        {
+        case THINKING:
+            client.retries = 0;
+            send(id, lb, now);
+            break;
+        case BACKING_OFF:
+            send(id, lb, now);
+            break;
+        case WAITING:
+            timeout_count++;
+            retryOrGiveUp(client, now);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Matches a completed request to the client waiting on it.
+ *
+ * Only the client's latest attempt counts as goodput; completions of attempts
+ * that already timed out were wasted server time.
+ *
+ * @param req The completed request.
+ * @param now Current simulation time.
+ */
+void ClientPopulation::onCompletion(const Request &req, int now)
+{
+    if (req.client_id < 0 || req.client_id >= (int)clients.size())
+    {
+        return;
+    }
+
+    Client &client = clients[req.client_id];
+    if (client.state == WAITING && req.attempt == client.attempt)
+    {
+        good_count++;
+        startThinking(client, now);
+    }
+    else
+    {
+        late_count++;
+    }
+}
+
+/**
+ * @brief Returns the number of clients in the population.
+ * @return Number of clients.
+ */
+int ClientPopulation::getClientCount()
+{
+    return clients.size();
+}
+
+/**
+ * @brief Returns the total number of requests sent, including retries.
+ * @return Number of requests offered.
+ */
+int ClientPopulation::getSentCount()
+{
+    return sent_count;
+}
+
+/**
+ * @brief Returns the number of retries sent.
+ * @return Number of retries.
+ */
+int ClientPopulation::getRetryCount()
+{
+    return retry_count;
+}
+
+/**
+ * @brief Returns the number of requests that timed out.
+ * @return Number of timeouts.
+ */
+int ClientPopulation::getTimeoutCount()
+{
+    return timeout_count;
+}
+
+/**
+ * @brief Returns the number of sends rejected by the load balancer.
+ * @return Number of rejected sends.
+ */
+int ClientPopulation::getRejectedCount()
+{
+    return rejected_count;
+}
+
+/**
+ * @brief Returns the number of completions received before timeout.
+ * @return Number of useful completions.
+ */
+int ClientPopulation::getGoodCount()
+{
+    return good_count;
+}
+
+/**
+ * @brief Returns the number of completions received after timeout.
+ * @return Number of wasted completions.
+ */
+int ClientPopulation::getLateCount()
+{
+    return late_count;
+}
+
+/**
+ * @brief Returns the number of requests abandoned after the last retry.
+ * @return Number of failed requests.
+ */
+int ClientPopulation::getFailedCount()
+{
+    return failed_count;
+}
+
+/**
+ * @brief Builds a new attempt for the client and offers it to the load balancer.
+ *
+ * Accepted requests start the timeout clock; rejected ones go straight to backoff.
+ *
+ * @param id Index of the client.
+ * @param lb The load balancer receiving the request.
+ * @param now Current simulation time.
+ */
+void ClientPopulation::send(int id, LoadBalancer &lb, int now)
+{
+    Client &client = clients[id];
+    Request req = generateRandomRequest();
+    req.ip_in = client.ip;
+    req.client_id = id;
+    req.attempt = ++client.attempt;
+    sent_count++;
+
+    if (lb.addRequest(req))
+    {
+        client.state = WAITING;
+        client.next_event = now + timeout;
+    }
+    else
+    {
+        rejected_count++;
+        retryOrGiveUp(client, now);
+    }
+}
+
+/**
+ * @brief Schedules a retry after a jittered exponential backoff, or gives up.
+ *
+ * The backoff ceiling doubles with every retry up to max_backoff, and the actual
+ * delay is drawn uniformly below it ("full jitter") to spread retries out. The
+ * ceiling is doubled step by step so it cannot overflow, and is at least one cycle.
+ *
+ * @param client The client whose request failed.
+ * @param now Current simulation time.
+ */
+void ClientPopulation::retryOrGiveUp(Client &client, int now)
+{
+    if (client.retries >= max_retries)
+    {
+        failed_count++;
+        startThinking(client, now);
+        return;
+    }
+
+    int ceiling = max(1, base_backoff);
+    for (int i = 0; i < client.retries && ceiling < max_backoff; ++i)
+    {
+        ceiling = ceiling > max_backoff / 2 ? max_backoff : ceiling * 2;
+    }
+    ceiling = max(1, min(ceiling, max_backoff));
+
+    client.retries++;
+    retry_count++;
+    client.state = BACKING_OFF;
+    client.next_event = now + 1 + rand() % ceiling;
+}
+
+/**
+ * @brief Puts the client to sleep for a think time drawn uniformly from [0, 2 * think_time].
+ * @param client The client to idle.
+ * @param now Current simulation time.
+ */
+void ClientPopulation::startThinking(Client &client, int now)
+{
+    client.state = THINKING;
+    client.next_event = now + rand() % (2 * think_time + 1);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file LRUCache.cpp
+ * @brief Implements the LRUCache class and CacheConfig key selection.
+ */
+
+#include "../headers/LRUCache.h"
+#include "../headers/utility.h"
+
+using namespace std;
+
+/**
+ * @brief Computes the cache key of a request under this configuration.
+ * @param req The request to key.
+ * @return The request's content key or packed source IP.
+ */
+uint32_t CacheConfig::keyFor(const Request &req) const
+{
+    return by_content ? req.content_key : packIPv4(req.ip_in);
+}
+
+/**
+ * @brief Constructs an empty cache with the given capacity.
+ * @param capacity Maximum number of keys held.
+ */
+LRUCache::LRUCache(int capacity) : capacity(capacity), hits(0), misses(0) {}
+
+/**
+ * @brief Looks up a key and updates recency.
+ *
+ * A hit moves the key to the front. A miss inserts it at the front and evicts the
+ * least recently used key if the cache is over capacity.
+ *
+ * @param key The key to access.
+ * @return True on a hit, false on a miss.
+ */
+bool LRUCache::access(uint32_t key)
+{
+    auto found = index.find(key);
+    if (found != index.end())
+    {
+        recency.splice(recency.begin(), recency, found->second);
+        hits++;
+        return true;
+    }
+
+    misses++;
+    if (capacity <= 0)
+    {
+        return false;
+    }
+
+    recency.push_front(key);
+    index[key] = recency.begin();
+    if ((int)recency.size() > capacity)
+    {
+        index.erase(recency.back());
+        recency.pop_back();
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the number of accesses that hit.
+ * @return Hit count.
+ */
+int LRUCache::getHits()
+{
+    return hits;
+}
+
+/**
+ * @brief Returns the number of accesses that missed.
+ * @return Miss count.
+ */
+int LRUCache::getMisses()
+{
+    return misses;
+}
@@ -4,6 +4,7 @@
  */
 
 #include "../headers/LoadBalancer.h"
+#include "../headers/ClientPopulation.h"
 #include "../headers/utility.h"
 #include <iostream>
 using namespace std;
@@ -11,12 +12,20 @@ using namespace std;
 /**
  * @brief Constructs the LoadBalancer with the specified number of web servers.
  * @param num_servers Number of web servers to initialize.
+ * @param config Concurrency, cache, routing, and rate-limit settings.
  */
-LoadBalancer::LoadBalancer(int num_servers) : time(0), rejected_requests(0)
+LoadBalancer::LoadBalancer(int num_servers, LoadBalancerConfig config)
+    : rateLimiter(config.rate_limit.burst, config.rate_limit.refill_interval, config.rate_limit.idle_timeout),
+      rate_limiting(config.rate_limit.burst > 0), time(0), rejected_requests(0),
+      server_concurrency(config.server_concurrency),
+      retired_processed(0), cache_config(config.cache), affinity_routing(config.affinity_routing),
+      retired_cache_hits(0), retired_cache_misses(0), retired_cpu_busy_cycles(0),
+      completed_last_tick(0),
+      recorded_rejections(0), snapshot_interval(0), clients(nullptr)
 {
     for (int i = 0; i < num_servers; ++i)
     {
-        servers.push_back(new WebServer());
+        servers.push_back(new WebServer(server_concurrency, cache_config));
     }
 }
 
@@ -32,61 +41,106 @@ LoadBalancer::~LoadBalancer()
 }
 
 /**
- * @brief Adds a new request to the queue if space is available.
+ * @brief Adds a new request to the queue if its source is within its rate limit and space is available.
+ *        Rate-limited requests are counted by the RateLimiter.
  *        Increments rejected_requests counter if the queue is full.
  * @param req The Request to add.
+ * @return True if the request was queued, false otherwise.
  */
-void LoadBalancer::addRequest(Request req)
+bool LoadBalancer::addRequest(Request req)
 {
+    if (rate_limiting && !rateLimiter.allow(packIPv4(req.ip_in), time))
+    {
+        return false;
+    }
 
     if (requestQueue.size() > 1000)
     {
         rejected_requests++;
+        return false;
     }
-    else
-    {
-        requestQueue.enqueue(req);
-    }
+
+    requestQueue.enqueue(req);
+    return true;
 }
 
 /**
- * @brief Assigns queued requests to idle web servers.
+ * @brief Assigns queued requests to web servers until each is at its concurrency limit.
+ *
+ * With affinity routing, a server with room takes the first request among the
+ * next AFFINITY_WINDOW in the queue whose cache key hashes to it, and falls back
+ * to the front of the queue if there is none. Keys are mapped by modulo over the
+ * current server count, so scaling the pool moves most keys to a different (cold) server.
  */
 void LoadBalancer::assignRequests()
 {
-    for (WebServer *server : servers)
+    for (size_t i = 0; i < servers.size(); ++i)
     {
-        if (!server->isRunning() && !requestQueue.isEmpty())
+        WebServer *server = servers[i];
+        while (server->canAccept() && !requestQueue.isEmpty())
         {
-            server->assignRequest(requestQueue.dequeue());
+            int pick = 0;
+            if (affinity_routing)
+            {
+                int window = requestQueue.size();
+                if (window > AFFINITY_WINDOW)
+                {
+                    window = AFFINITY_WINDOW;
+                }
+                for (int j = 0; j < window; ++j)
+                {
+                    uint32_t hash = (cache_config.keyFor(requestQueue.at(j)) * 2654435769u) >> 8;
+                    if (hash % servers.size() == i)
+                    {
+                        pick = j;
+                        break;
+                    }
+                }
+            }
+            server->assignRequest(requestQueue.removeAt(pick));
         }
     }
 }
 
 /**
  * @brief Advances the simulation by one clock cycle by ticking all servers and incrementing internal time.
+ *        Requests that finish this cycle are counted and passed to the attached client population.
  */
 void LoadBalancer::tick()
 {
+    completed_last_tick = 0;
     for (WebServer *server : servers)
     {
         server->tick();
+        completed_last_tick += server->getCompletedRequests().size();
+        if (clients)
+        {
+            for (const Request &req : server->getCompletedRequests())
+            {
+                clients->onCompletion(req, time);
+            }
+        }
     }
     time++;
 }
 
 /**
  * @brief Runs the simulation for total_cycles, generating new requests based on new_request_chance.
- *        Scales servers dynamically and logs status every 500 cycles.
+ *        Scales servers dynamically and logs status every snapshot_interval cycles, if set.
  * @param total_cycles Number of simulation cycles.
  * @param new_request_chance Percentage chance (0-100) of generating a new request each cycle.
  * @param logfile Output stream to write simulation logs.
  */
 void LoadBalancer::simulate(int total_cycles, int new_request_chance, ostream &logfile)
 {
-    logfile << "Starting Queue Size: " << getQueueSize() << "\n\n";
-    logfile << "Cycle | Queue Size | Active Servers | Inactive Servers | Total Servers | Rejected Requests | Processed Requests\n";
-    logfile << "----------------------------------------------------------------------------------------------------------------\n";
+    recorded_rejections = getRejectedRequests() + getRateLimitedRequests();
+
+    logfile << "Starting Queue Size: " << getQueueSize() << "\n";
+    if (snapshot_interval > 0)
+    {
+        logfile << "\nCycle | Queue Size | Active Servers | Inactive Servers | Total Servers | Rejected Requests | Rate Limited Requests | Processed Requests\n";
+        logfile << "--------------------------------------------------------------------------------------------------------------------------------------\n";
+    }
 
     for (int cycle = 0; cycle <= total_cycles; ++cycle)
     {
@@ -98,8 +152,9 @@ void LoadBalancer::simulate(int total_cycles, int new_request_chance, ostream &l
         {
             addRequest(generateRandomRequest());
         }
+        recordStats();
 
-        if (cycle % 250 == 0)
+        if (snapshot_interval > 0 && cycle % snapshot_interval == 0)
         {
             logfile << cycle << " | "
                     << getQueueSize() << " | "
@@ -107,6 +162,7 @@ void LoadBalancer::simulate(int total_cycles, int new_request_chance, ostream &l
                     << getInactiveServerCount() << " | "
                     << getServerCount() << " | "
                     << getRejectedRequests() << " | "
+                    << getRateLimitedRequests() << " | "
                     << getTotalProcessedRequests() << "\n";
         }
     }
@@ -115,6 +171,89 @@ void LoadBalancer::simulate(int total_cycles, int new_request_chance, ostream &l
     logfile << "Final Queue Size: " << getQueueSize() << "\n";
     logfile << "Total Requests Processed: " << getTotalProcessedRequests() << "\n";
     logfile << "Range for Task Times: [10, 19]\n";
+    if (cache_config.capacity > 0)
+    {
+        logfile << "Cache Hit Rate: " << getCacheHitRate() << "\n";
+    }
+    logfile << "Rejected Requests (Queue Full): " << getRejectedRequests() << "\n";
+    logfile << "Rate Limited Requests: " << getRateLimitedRequests() << "\n";
+
+    vector<RateLimiter::Offender> offenders = getTopRateLimitedSources();
+    if (!offenders.empty())
+    {
+        logfile << "Top Rate Limited Sources:\n";
+        for (const RateLimiter::Offender &offender : offenders)
+        {
+            logfile << "  " << unpackIPv4(offender.ip) << " | " << offender.limited << "\n";
+        }
+    }
+
+    logStats(logfile);
+}
+
+/**
+ * @brief Runs the simulation for total_cycles with requests generated by a closed-loop client population.
+ *        Scales servers dynamically and logs status every snapshot_interval cycles, if set.
+ * @param total_cycles Number of simulation cycles.
+ * @param population The clients generating requests and receiving completions.
+ * @param logfile Output stream to write simulation logs.
+ */
+void LoadBalancer::simulateClosedLoop(int total_cycles, ClientPopulation &population, ostream &logfile)
+{
+    clients = &population;
+    recorded_rejections = getRejectedRequests() + getRateLimitedRequests();
+
+    logfile << "Clients: " << population.getClientCount() << "\n";
+    if (snapshot_interval > 0)
+    {
+        logfile << "\nCycle | Queue Size | Active Servers | Total Servers | Sent Requests | Retries | Timeouts | Rejected Requests | Rate Limited Requests | Good Completions | Late Completions\n";
+        logfile << "--------------------------------------------------------------------------------------------------------------------------------------------------------------------\n";
+    }
+
+    for (int cycle = 0; cycle <= total_cycles; ++cycle)
+    {
+        assignRequests();
+        tick();
+        scaleServers();
+        population.tick(*this, time);
+        recordStats();
+
+        if (snapshot_interval > 0 && cycle % snapshot_interval == 0)
+        {
+            logfile << cycle << " | "
+                    << getQueueSize() << " | "
+                    << getBusyServerCount() << " | "
+                    << getServerCount() << " | "
+                    << population.getSentCount() << " | "
+                    << population.getRetryCount() << " | "
+                    << population.getTimeoutCount() << " | "
+                    << getRejectedRequests() << " | "
+                    << getRateLimitedRequests() << " | "
+                    << population.getGoodCount() << " | "
+                    << population.getLateCount() << "\n";
+        }
+    }
+
+    double cycles = total_cycles + 1;
+    logfile << "\nSimulation complete.\n";
+    logfile << "Final Queue Size: " << getQueueSize() << "\n";
+    logfile << "Offered Load (requests/cycle): " << population.getSentCount() / cycles << "\n";
+    logfile << "Throughput (completions/cycle): " << (population.getGoodCount() + population.getLateCount()) / cycles << "\n";
+    logfile << "Goodput (completions/cycle): " << population.getGoodCount() / cycles << "\n";
+    logfile << "Failed Requests (Retries Exhausted): " << population.getFailedCount() << "\n";
+
+    logStats(logfile);
+
+    clients = nullptr;
+}
+
+/**
+ * @brief Sets the number of cycles between logged status rows.
+ * @param cycles Cycles between rows, or 0 to disable them.
+ */
+void LoadBalancer::setSnapshotInterval(int cycles)
+{
+    snapshot_interval = cycles;
 }
 
 /**
@@ -152,13 +291,41 @@ int LoadBalancer::getBusyServerCount()
     return busy_count;
 }
 
+/**
+ * @brief Counts the requests currently in flight across all servers.
+ * @return Number of assigned, unfinished requests.
+ */
+int LoadBalancer::getActiveRequestCount()
+{
+    int total = 0;
+    for (WebServer *server : servers)
+    {
+        total += server->getActiveRequestCount();
+    }
+    return total;
+}
+
+/**
+ * @brief Returns the busy CPU cycles of all current and removed servers.
+ * @return Total busy CPU cycles.
+ */
+int LoadBalancer::getCpuBusyCycles()
+{
+    int total = retired_cpu_busy_cycles;
+    for (WebServer *server : servers)
+    {
+        total += server->getCpuBusyCycles();
+    }
+    return total;
+}
+
 /**
  * @brief Returns total requests processed by all servers.
  * @return Total number of processed requests.
  */
 int LoadBalancer::getTotalProcessedRequests()
 {
-    int total = 0;
+    int total = retired_processed;
     for (WebServer *server : servers)
     {
         total += server->getProcessedRequestCount();
@@ -175,6 +342,99 @@ int LoadBalancer::getRejectedRequests()
     return rejected_requests;
 }
 
+/**
+ * @brief Returns the total number of requests rejected by per-source rate limiting.
+ * @return Number of rate-limited requests.
+ */
+int LoadBalancer::getRateLimitedRequests()
+{
+    return rateLimiter.getLimitedCount();
+}
+
+/**
+ * @brief Returns the sources with the most rate-limited requests, highest first.
+ * @return Up to RateLimiter::MAX_OFFENDERS offenders.
+ */
+vector<RateLimiter::Offender> LoadBalancer::getTopRateLimitedSources()
+{
+    return rateLimiter.getTopOffenders();
+}
+
+/**
+ * @brief Returns the number of cache hits across current and removed servers.
+ * @return Total cache hits.
+ */
+int LoadBalancer::getCacheHits()
+{
+    int total = retired_cache_hits;
+    for (WebServer *server : servers)
+    {
+        total += server->getCacheHits();
+    }
+    return total;
+}
+
+/**
+ * @brief Returns the number of cache misses across current and removed servers.
+ * @return Total cache misses.
+ */
+int LoadBalancer::getCacheMisses()
+{
+    int total = retired_cache_misses;
+    for (WebServer *server : servers)
+    {
+        total += server->getCacheMisses();
+    }
+    return total;
+}
+
+/**
+ * @brief Calculates the fraction of assigned requests that hit a server cache.
+ * @return Hit rate in [0, 1].
+ */
+double LoadBalancer::getCacheHitRate()
+{
+    int hits = getCacheHits();
+    int lookups = hits + getCacheMisses();
+    return lookups > 0 ? (double)hits / lookups : 0.0;
+}
+
+/**
+ * @brief Returns the per-cycle statistics of the request queue size.
+ * @return Queue size statistics.
+ */
+const StreamingStats &LoadBalancer::getQueueStats()
+{
+    return queue_stats;
+}
+
+/**
+ * @brief Returns the per-cycle statistics of the number of busy servers.
+ * @return Busy server statistics.
+ */
+const StreamingStats &LoadBalancer::getBusyServerStats()
+{
+    return busy_stats;
+}
+
+/**
+ * @brief Returns the per-cycle statistics of the number of completed requests.
+ * @return Throughput statistics.
+ */
+const StreamingStats &LoadBalancer::getThroughputStats()
+{
+    return throughput_stats;
+}
+
+/**
+ * @brief Returns the per-cycle statistics of the number of rejected and rate-limited requests.
+ * @return Rejection statistics.
+ */
+const StreamingStats &LoadBalancer::getRejectionStats()
+{
+    return rejection_stats;
+}
+
 /**
  * @brief Calculates the number of inactive (idle) servers.
  * @return Number of inactive servers.
@@ -195,7 +455,7 @@ void LoadBalancer::scaleServers()
 
     if (queue_size > 500 && servers.size() < 20)
     {
-        servers.push_back(new WebServer());
+        servers.push_back(new WebServer(server_concurrency, cache_config));
     }
     else if (queue_size < 100 && servers.size() > 5)
     {
@@ -203,6 +463,10 @@ void LoadBalancer::scaleServers()
         {
             if (!(*it)->isRunning())
             {
+                retired_processed += (*it)->getProcessedRequestCount();
+                retired_cache_hits += (*it)->getCacheHits();
+                retired_cache_misses += (*it)->getCacheMisses();
+                retired_cpu_busy_cycles += (*it)->getCpuBusyCycles();
                 delete *it;
                 servers.erase(it);
                 break;
@@ -210,3 +474,90 @@ void LoadBalancer::scaleServers()
         }
     }
 }
+
+/**
+ * @brief Samples the current cycle's metrics into the streaming statistics.
+ *        Rejections are the queue-full and rate-limited requests since the previous sample,
+ *        or since the simulation started, so requests rejected while filling the initial
+ *        queue are not counted.
+ */
+void LoadBalancer::recordStats()
+{
+    int rejections = getRejectedRequests() + getRateLimitedRequests();
+
+    queue_stats.add(getQueueSize());
+    busy_stats.add(getBusyServerCount());
+    throughput_stats.add(completed_last_tick);
+    rejection_stats.add(rejections - recorded_rejections);
+
+    recorded_rejections = rejections;
+}
+
+/**
+ * @brief Writes a summary row per metric, followed by the downsampled time series.
+ *
+ * The per-1000-cycle series is always printed. Each coarser tier is printed as well
+ * while the finer one no longer covers the whole run, so recent history stays at
+ * fine resolution and the coarsest tier covers the rest. The last row of each tier
+ * is its partially filled bucket, with fewer cycles than the resolution.
+ *
+ * @param logfile Output stream to write to.
+ */
+void LoadBalancer::logStats(ostream &logfile)
+{
+    const char *names[] = {"Queue Size", "Busy Servers", "Throughput", "Rejections"};
+    const StreamingStats *stats[] = {&queue_stats, &busy_stats, &throughput_stats, &rejection_stats};
+
+    logfile << "\nStreaming Statistics (per cycle, window of last " << StreamingStats::TIER_LENGTH << " cycles)\n\n";
+    logfile << "Metric | Min | Max | Mean | EWMA | Window Mean | Window Max | p50 | p90 | p99\n";
+    logfile << "---------------------------------------------------------------------------\n";
+    for (int i = 0; i < 4; ++i)
+    {
+        logfile << names[i] << " | "
+                << stats[i]->getMin() << " | "
+                << stats[i]->getMax() << " | "
+                << stats[i]->getMean() << " | "
+                << stats[i]->getEWMA() << " | "
+                << stats[i]->getWindowMean() << " | "
+                << stats[i]->getWindowMax() << " | "
+                << stats[i]->getMedian() << " | "
+                << stats[i]->getP90() << " | "
+                << stats[i]->getP99() << "\n";
+    }
+
+    long long samples = queue_stats.getCount();
+    for (int tier = 1; tier < StreamingStats::TIER_COUNT; ++tier)
+    {
+        long long resolution = StreamingStats::getTierResolution(tier);
+        if (tier > 1 && samples <= StreamingStats::getTierResolution(tier - 1) * StreamingStats::TIER_LENGTH)
+        {
+            break;
+        }
+
+        vector<StatBucket> series[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            series[i] = stats[i]->getSeries(tier);
+        }
+        if (series[0].empty())
+        {
+            continue;
+        }
+
+        long long closed = series[0].size() - (samples % resolution != 0 ? 1 : 0);
+        long long first_cycle = (samples / resolution - closed) * resolution;
+        logfile << "\nTime Series (per " << resolution << " cycles)\n\n";
+        logfile << "Start Cycle | Cycles | Queue Mean | Queue Max | Busy Servers Mean | Throughput Mean | Rejections\n";
+        logfile << "----------------------------------------------------------------------------------------------\n";
+        for (size_t j = 0; j < series[0].size(); ++j)
+        {
+            logfile << first_cycle + (long long)j * resolution << " | "
+                    << series[0][j].count << " | "
+                    << series[0][j].mean() << " | "
+                    << series[0][j].max << " | "
+                    << series[1][j].mean() << " | "
+                    << series[2][j].mean() << " | "
+                    << series[3][j].sum << "\n";
+        }
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file RateLimiter.cpp
+ * @brief Implements the RateLimiter class for per-source token-bucket admission control.
+ */
+
+#include "../headers/RateLimiter.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    const uint32_t INITIAL_CAPACITY = 1024; ///< Starting table size; must be a power of two.
+    const uint32_t HASH_MULTIPLIER = 2654435769u; ///< 2^32 divided by the golden ratio.
+
+    /**
+     * @brief Returns log2 of a power-of-two capacity.
+     */
+    int log2Capacity(uint32_t capacity)
+    {
+        int bits = 0;
+        while ((1u << bits) < capacity)
+        {
+            bits++;
+        }
+        return bits;
+    }
+}
+
+/**
+ * @brief Constructs a RateLimiter with an empty table.
+ *
+ * idle_timeout is raised to at least burst * refill_interval, the time an empty
+ * bucket takes to refill, so that only full buckets are ever discarded.
+ *
+ * @param burst Maximum number of requests a source may send back-to-back.
+ * @param refill_interval Number of cycles needed to earn one token.
+ * @param idle_timeout Number of idle cycles after which a source's bucket is discarded.
+ */
+RateLimiter::RateLimiter(int burst, int refill_interval, int idle_timeout)
+    : mask(INITIAL_CAPACITY - 1), shift(32 - log2Capacity(INITIAL_CAPACITY)),
+      live_count(0), max_tokens(burst * refill_interval), cost(refill_interval),
+      idle_timeout(max(idle_timeout, burst * refill_interval)), last_sweep(0), limited_count(0)
+{
+    Bucket empty = {0, -1, 0, 0};
+    table.assign(INITIAL_CAPACITY, empty);
+}
+
+/**
+ * @brief Refills the source's bucket for the elapsed time and charges one request against it.
+ *
+ * New sources start with a full bucket. The table grows once it is 70% full and is
+ * swept of idle buckets every idle_timeout cycles.
+ *
+ * @param ip Packed IPv4 address of the source.
+ * @param now Current simulation time.
+ * @return True if the request is admitted, false if the source is out of tokens.
+ */
+bool RateLimiter::allow(uint32_t ip, int now)
+{
+    if (now - last_sweep >= idle_timeout)
+    {
+        expireIdle(now);
+    }
+
+    uint32_t slot = findSlot(ip);
+    if (table[slot].last_seen < 0 && (uint32_t)(live_count + 1) * 10 > (mask + 1) * 7)
+    {
+        rebuild((mask + 1) * 2, now);
+        slot = findSlot(ip);
+    }
+
+    Bucket &bucket = table[slot];
+    if (bucket.last_seen < 0)
+    {
+        bucket.ip = ip;
+        bucket.last_seen = now;
+        bucket.tokens = max_tokens;
+        bucket.limited = 0;
+        live_count++;
+    }
+    else
+    {
+        bucket.tokens = min(max_tokens, bucket.tokens + (now - bucket.last_seen));
+        bucket.last_seen = now;
+    }
+
+    if (bucket.tokens >= cost)
+    {
+        bucket.tokens -= cost;
+        return true;
+    }
+
+    bucket.limited++;
+    limited_count++;
+    recordOffender(ip, bucket.limited);
+    return false;
+}
+
+/**
+ * @brief Drops every bucket that has been idle for at least idle_timeout cycles.
+ *
+ * Because idle_timeout is never shorter than the refill time, an idle bucket has
+ * refilled completely by then, so forgetting it does not change any future
+ * admission decision. The table is shrunk when it has become mostly empty.
+ *
+ * @param now Current simulation time.
+ */
+void RateLimiter::expireIdle(int now)
+{
+    last_sweep = now;
+
+    int live = 0;
+    for (const Bucket &bucket : table)
+    {
+        if (bucket.last_seen >= 0 && now - bucket.last_seen < idle_timeout)
+        {
+            live++;
+        }
+    }
+
+    uint32_t capacity = mask + 1;
+    while (capacity > INITIAL_CAPACITY && (uint32_t)live * 10 < capacity * 2)
+    {
+        capacity /= 2;
+    }
+    rebuild(capacity, now);
+}
+
+/**
+ * @brief Returns the total number of requests rejected by the limiter.
+ * @return Number of rate-limited requests.
+ */
+int RateLimiter::getLimitedCount()
+{
+    return limited_count;
+}
+
+/**
+ * @brief Returns the number of sources currently holding a bucket.
+ * @return Number of live buckets.
+ */
+int RateLimiter::getTrackedSourceCount()
+{
+    return live_count;
+}
+
+/**
+ * @brief Returns the top offending sources sorted by descending limited count.
+ * @return Up to MAX_OFFENDERS offenders.
+ */
+vector<RateLimiter::Offender> RateLimiter::getTopOffenders()
+{
+    vector<Offender> sorted = offenders;
+    sort(sorted.begin(), sorted.end(), [](const Offender &a, const Offender &b)
+         { return a.limited > b.limited; });
+    return sorted;
+}
+
+/**
+ * @brief Linearly probes from the hashed home slot until ip or an empty slot is found.
+ * @param ip Packed IPv4 address to look up.
+ * @return Index of the matching or first empty slot.
+ */
+uint32_t RateLimiter::findSlot(uint32_t ip)
+{
+    uint32_t slot = (ip * HASH_MULTIPLIER) >> shift;
+    while (table[slot].last_seen >= 0 && table[slot].ip != ip)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Reinserts every non-idle bucket into a freshly cleared table of the given capacity.
+ *
+ * Rebuilding also removes the gaps left by expired buckets, so lookups never need
+ * tombstones. The old storage is kept in scratch and reused by the next rebuild.
+ *
+ * @param capacity New capacity; must be a power of two.
+ * @param now Current simulation time.
+ */
+void RateLimiter::rebuild(uint32_t capacity, int now)
+{
+    Bucket empty = {0, -1, 0, 0};
+    scratch.swap(table);
+    table.assign(capacity, empty);
+    mask = capacity - 1;
+    shift = 32 - log2Capacity(capacity);
+    live_count = 0;
+
+    for (const Bucket &bucket : scratch)
+    {
+        if (bucket.last_seen >= 0 && now - bucket.last_seen < idle_timeout)
+        {
+            table[findSlot(bucket.ip)] = bucket;
+            live_count++;
+        }
+    }
+}
+
+/**
+ * @brief Updates the bounded top-offender list after a request from ip was limited.
+ *
+ * A source already in the list has its count incremented. Otherwise it takes a free
+ * slot, or replaces the smallest entry if its current bucket has been limited more often.
+ *
+ * @param ip Packed IPv4 address of the source.
+ * @param bucket_limited The source's limited count in its current bucket.
+ */
+void RateLimiter::recordOffender(uint32_t ip, int bucket_limited)
+{
+    int smallest = -1;
+    for (size_t i = 0; i < offenders.size(); ++i)
+    {
+        if (offenders[i].ip == ip)
+        {
+            offenders[i].limited++;
+            return;
+        }
+        if (smallest < 0 || offenders[i].limited < offenders[smallest].limited)
+        {
+            smallest = i;
+        }
+    }
+
+    Offender offender = {ip, bucket_limited};
+    if (offenders.size() < (size_t)MAX_OFFENDERS)
+    {
+        offenders.push_back(offender);
+    }
+    else if (bucket_limited > offenders[smallest].limited)
+    {
+        offenders[smallest] = offender;
+    }
+}
@@ -21,7 +21,7 @@ RequestQueue::RequestQueue() {}
  */
 void RequestQueue::enqueue(Request req)
 {
-    q.push(req);
+    q.push_back(req);
 }
 
 /**
@@ -36,7 +36,7 @@ Request RequestQueue::dequeue()
         throw runtime_error("Queue is empty");
     }
     Request front = q.front();
-    q.pop();
+    q.pop_front();
     return front;
 }
 
@@ -54,6 +54,38 @@ Request RequestQueue::front()
     return q.front();
 }
 
+/**
+ * @brief Returns the request at the given position without removing it.
+ * @param index Position in the queue, where 0 is the front.
+ * @return The Request at that position.
+ * @throws std::out_of_range if index is not a valid position.
+ */
+const Request &RequestQueue::at(int index)
+{
+    if (index < 0 || index >= (int)q.size())
+    {
+        throw out_of_range("Queue index out of range");
+    }
+    return q[index];
+}
+
+/**
+ * @brief Removes and returns the request at the given position.
+ * @param index Position in the queue, where 0 is the front.
+ * @return The removed Request.
+ * @throws std::out_of_range if index is not a valid position.
+ */
+Request RequestQueue::removeAt(int index)
+{
+    if (index < 0 || index >= (int)q.size())
+    {
+        throw out_of_range("Queue index out of range");
+    }
+    Request req = q[index];
+    q.erase(q.begin() + index);
+    return req;
+}
+
 /**
  * @brief Checks whether the queue is empty.
  * @return True if the queue is empty, false otherwise.
@@ -0,0 +1,374 @@
+/**
+ * @file StreamingStats.cpp
+ * @brief Implements bounded-memory online statistics: buckets, count histograms, and downsampling tiers.
+ */
+
+#include "../headers/StreamingStats.h"
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty bucket.
+ */
+StatBucket::StatBucket() : count(0), sum(0.0), min(0.0), max(0.0) {}
+
+/**
+ * @brief Adds one sample to the bucket.
+ * @param x The sample value.
+ */
+void StatBucket::add(double x)
+{
+    if (count == 0 || x < min)
+    {
+        min = x;
+    }
+    if (count == 0 || x > max)
+    {
+        max = x;
+    }
+    count++;
+    sum += x;
+}
+
+/**
+ * @brief Adds every sample summarized by another bucket.
+ * @param other The bucket to merge in.
+ */
+void StatBucket::merge(const StatBucket &other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+    if (count == 0 || other.min < min)
+    {
+        min = other.min;
+    }
+    if (count == 0 || other.max > max)
+    {
+        max = other.max;
+    }
+    count += other.count;
+    sum += other.sum;
+}
+
+/**
+ * @brief Calculates the mean of the summarized samples.
+ * @return The mean, or 0 if the bucket is empty.
+ */
+double StatBucket::mean() const
+{
+    return count > 0 ? sum / count : 0.0;
+}
+
+/**
+ * @brief Constructs an empty histogram.
+ */
+CountHistogram::CountHistogram() : count(0) {}
+
+/**
+ * @brief Adds one sample to its value's bin, growing the bins if the value is new and larger.
+ * @param x The sample value.
+ */
+void CountHistogram::add(double x)
+{
+    size_t value = x > 0 ? (size_t)(x + 0.5) : 0;
+    if (value >= bins.size())
+    {
+        bins.resize(value + 1, 0);
+    }
+    bins[value]++;
+    count++;
+}
+
+/**
+ * @brief Returns the nearest-rank quantile: the smallest value whose cumulative count reaches p * count.
+ *
+ * Higher p can only stop at the same or a later bin, so quantiles are always ordered.
+ *
+ * @param p Target quantile in (0, 1].
+ * @return The quantile, or 0 if no samples have been added.
+ */
+double CountHistogram::quantile(double p) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    long long rank = (long long)ceil(p * count);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    long long seen = 0;
+    for (size_t value = 0; value < bins.size(); ++value)
+    {
+        seen += bins[value];
+        if (seen >= rank)
+        {
+            return value;
+        }
+    }
+    return bins.size() - 1;
+}
+
+/**
+ * @brief Constructs empty statistics with TIER_COUNT empty tiers.
+ * @param ewma_alpha Weight given to each new sample in the moving average.
+ */
+StreamingStats::StreamingStats(double ewma_alpha)
+    : ewma_alpha(ewma_alpha), ewma(0.0), window_sum(0.0), tiers(TIER_COUNT)
+{
+    for (Tier &tier : tiers)
+    {
+        tier.ring.reserve(TIER_LENGTH);
+        tier.next = 0;
+    }
+}
+
+/**
+ * @brief Records one sample in every running statistic and in tier 0.
+ * @param x The sample value.
+ */
+void StreamingStats::add(double x)
+{
+    ewma = total.count == 0 ? x : ewma + ewma_alpha * (x - ewma);
+    total.add(x);
+    histogram.add(x);
+
+    addToWindow(total.count - 1, x);
+
+    StatBucket sample;
+    sample.add(x);
+    addToTier(0, sample);
+}
+
+/**
+ * @brief Returns the number of samples recorded.
+ * @return Sample count.
+ */
+long long StreamingStats::getCount() const
+{
+    return total.count;
+}
+
+/**
+ * @brief Returns the smallest sample recorded.
+ * @return Minimum.
+ */
+double StreamingStats::getMin() const
+{
+    return total.min;
+}
+
+/**
+ * @brief Returns the largest sample recorded.
+ * @return Maximum.
+ */
+double StreamingStats::getMax() const
+{
+    return total.max;
+}
+
+/**
+ * @brief Returns the mean of all samples recorded.
+ * @return Mean.
+ */
+double StreamingStats::getMean() const
+{
+    return total.mean();
+}
+
+/**
+ * @brief Returns the exponentially weighted moving average.
+ * @return EWMA.
+ */
+double StreamingStats::getEWMA() const
+{
+    return ewma;
+}
+
+/**
+ * @brief Returns the mean of the samples in the moving window, using a running sum.
+ * @return Window mean.
+ */
+double StreamingStats::getWindowMean() const
+{
+    const vector<StatBucket> &window = tiers[0].ring;
+    return window.empty() ? 0.0 : window_sum / window.size();
+}
+
+/**
+ * @brief Returns the smallest sample in the moving window from the front of its monotonic deque.
+ * @return Window minimum.
+ */
+double StreamingStats::getWindowMin() const
+{
+    return window_min.empty() ? 0.0 : window_min.front().value;
+}
+
+/**
+ * @brief Returns the largest sample in the moving window from the front of its monotonic deque.
+ * @return Window maximum.
+ */
+double StreamingStats::getWindowMax() const
+{
+    return window_max.empty() ? 0.0 : window_max.front().value;
+}
+
+/**
+ * @brief Returns the median.
+ * @return Median.
+ */
+double StreamingStats::getMedian() const
+{
+    return histogram.quantile(0.5);
+}
+
+/**
+ * @brief Returns the 90th percentile.
+ * @return 90th percentile.
+ */
+double StreamingStats::getP90() const
+{
+    return histogram.quantile(0.9);
+}
+
+/**
+ * @brief Returns the 99th percentile.
+ * @return 99th percentile.
+ */
+double StreamingStats::getP99() const
+{
+    return histogram.quantile(0.99);
+}
+
+/**
+ * @brief Returns the number of samples per bucket in a tier: 1, 1000, 1000000, ...
+ * @param tier Tier index.
+ * @return Samples per bucket.
+ */
+long long StreamingStats::getTierResolution(int tier)
+{
+    long long resolution = 1;
+    for (int i = 0; i < tier; ++i)
+    {
+        resolution *= TIER_LENGTH;
+    }
+    return resolution;
+}
+
+/**
+ * @brief Returns the retained buckets of a tier in time order.
+ *
+ * The closed buckets in the ring are followed by the open bucket, if it holds any
+ * samples, so the series always reaches the most recent sample.
+ *
+ * @param tier Tier index.
+ * @return Up to TIER_LENGTH closed buckets, oldest first, then the partial open bucket.
+ */
+vector<StatBucket> StreamingStats::getSeries(int tier) const
+{
+    const Tier &t = tiers[tier];
+    vector<StatBucket> series(t.ring.begin() + t.next, t.ring.end());
+    series.insert(series.end(), t.ring.begin(), t.ring.begin() + t.next);
+    if (t.open.count > 0)
+    {
+        series.push_back(t.open);
+    }
+    return series;
+}
+
+/**
+ * @brief Merges a bucket into a tier's open bucket and closes it once it reaches the tier's resolution.
+ *
+ * A closed bucket is written into the tier's ring, overwriting the oldest once the
+ * ring is full, and merged into the next tier. Tier 0's running window sum is
+ * recomputed each time its ring wraps so rounding error cannot accumulate.
+ *
+ * @param tier Tier index.
+ * @param bucket The samples to add.
+ */
+void StreamingStats::addToTier(int tier, const StatBucket &bucket)
+{
+    Tier &t = tiers[tier];
+    t.open.merge(bucket);
+    if (t.open.count < getTierResolution(tier))
+    {
+        return;
+    }
+
+    if ((int)t.ring.size() < TIER_LENGTH)
+    {
+        t.ring.push_back(t.open);
+    }
+    else
+    {
+        if (tier == 0)
+        {
+            window_sum -= t.ring[t.next].sum;
+        }
+        t.ring[t.next] = t.open;
+    }
+    t.next = (t.next + 1) % TIER_LENGTH;
+
+    if (tier == 0)
+    {
+        window_sum += t.open.sum;
+        if (t.next == 0)
+        {
+            window_sum = 0.0;
+            for (const StatBucket &sample : t.ring)
+            {
+                window_sum += sample.sum;
+            }
+        }
+    }
+
+    StatBucket closed = t.open;
+    t.open = StatBucket();
+    if (tier + 1 < TIER_COUNT)
+    {
+        addToTier(tier + 1, closed);
+    }
+}
+
+/**
+ * @brief Adds a sample to the monotonic deques behind the window minimum and maximum.
+ *
+ * A sample can never be the window minimum once a smaller or equal one arrives
+ * after it, so such samples are popped from the back before the new one is pushed;
+ * likewise for the maximum. The front is popped once it falls out of the last
+ * TIER_LENGTH samples. Each sample is pushed and popped at most once, so this is
+ * amortized constant time.
+ *
+ * @param index Zero-based position of the sample in the stream.
+ * @param x The sample value.
+ */
+void StreamingStats::addToWindow(long long index, double x)
+{
+    while (!window_min.empty() && window_min.back().value >= x)
+    {
+        window_min.pop_back();
+    }
+    while (!window_max.empty() && window_max.back().value <= x)
+    {
+        window_max.pop_back();
+    }
+
+    WindowEntry entry = {index, x};
+    window_min.push_back(entry);
+    window_max.push_back(entry);
+
+    if (window_min.front().index <= index - TIER_LENGTH)
+    {
+        window_min.pop_front();
+    }
+    if (window_max.front().index <= index - TIER_LENGTH)
+    {
+        window_max.pop_front();
+    }
+}
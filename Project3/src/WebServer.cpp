@@ -4,47 +4,131 @@
  */
 
 #include "../headers/WebServer.h"
+#include <algorithm>
+
+using namespace std;
 
 /**
  * @brief Constructs a WebServer object with default values.
  *
  * The server starts in an idle state with no active request.
+ *
+ * @param max_concurrency Maximum number of requests the server holds at once.
+ * @param cache_config Cache settings for this server.
  */
-WebServer::WebServer()
-    : running(false), time_remaining(0),
-      curr_request("", "", 0), processed_count(0) {}
+WebServer::WebServer(int max_concurrency, CacheConfig cache_config)
+    : running(false), max_concurrency(max_concurrency), cpu_task(-1),
+      curr_request("", "", 0), processed_count(0), cpu_busy_cycles(0),
+      cache_config(cache_config), cache(cache_config.capacity) {}
 
 /**
  * @brief Assigns a new request to the web server.
  *
- * Sets the current request, initializes the time remaining, and marks the server as running.
+ * Sets the current request, starts it at its first stage, and marks the server as running.
+ * A request without stages is treated as a single CPU stage of req.time cycles.
+ * On a cache hit every non-empty stage is shortened by the hit factor, to a minimum of one cycle.
+ * Leading zero-length stages are skipped right away so they do not cost a cycle; a request
+ * made only of zero-length stages still completes on the next tick.
  *
  * @param req The Request object to be processed by the server.
  */
 void WebServer::assignRequest(Request req)
 {
     curr_request = req;
-    time_remaining = req.time;
+    if (req.stages.empty())
+    {
+        RequestStage stage = {false, req.time};
+        req.stages.push_back(stage);
+    }
+
+    if (cache_config.capacity > 0 && cache.access(cache_config.keyFor(req)))
+    {
+        for (RequestStage &stage : req.stages)
+        {
+            if (stage.cycles > 0)
+            {
+                stage.cycles = max(1, (int)(stage.cycles * cache_config.hit_factor + 0.5));
+            }
+        }
+    }
+
+    Task task = {req, 0, req.stages[0].cycles};
+    if (task.remaining <= 0)
+    {
+        Task skipped = task;
+        if (!advance(skipped))
+        {
+            task = skipped;
+        }
+    }
+    tasks.push_back(task);
     running = true;
 }
 
 /**
  * @brief Advances the server by one clock cycle.
  *
- * Decrements the time remaining on the current request.
- * If the request is completed, the server becomes idle and increments its processed count.
+ * If no request holds the CPU, the oldest request ready for CPU work takes it.
+ * The CPU request and every request waiting on I/O then progress by one cycle.
+ * A request that reaches an I/O stage gives up the CPU; a request with no stages
+ * left is completed, increments the processed count, and is reported through
+ * getCompletedRequests() until the next tick.
  */
 void WebServer::tick()
 {
-    if (running)
+    completed.clear();
+    if (!running)
+    {
+        return;
+    }
+
+    if (cpu_task < 0)
     {
-        time_remaining--;
-        if (time_remaining <= 0)
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            if (!inIO(tasks[i]))
+            {
+                cpu_task = i;
+                break;
+            }
+        }
+    }
+
+    if (cpu_task >= 0)
+    {
+        cpu_busy_cycles++;
+    }
+
+    size_t kept = 0;
+    int next_cpu_task = -1;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        Task &task = tasks[i];
+        bool on_cpu = (int)i == cpu_task;
+        if (!on_cpu && !inIO(task))
+        {
+            tasks[kept++] = task;
+            continue;
+        }
+
+        task.remaining--;
+        if (task.remaining <= 0 && advance(task))
         {
-            running = false;
             processed_count++;
+            completed.push_back(task.request);
+            continue;
+        }
+
+        if (on_cpu && !inIO(task))
+        {
+            next_cpu_task = kept;
         }
+        tasks[kept++] = task;
     }
+
+    tasks.erase(tasks.begin() + kept, tasks.end());
+    cpu_task = next_cpu_task;
+    running = !tasks.empty();
 }
 
 /**
@@ -56,12 +140,33 @@ bool WebServer::isRunning()
     return running;
 }
 
+/**
+ * @brief Checks whether the server has room for another request.
+ * @return True if fewer than max_concurrency requests are in flight.
+ */
+bool WebServer::canAccept()
+{
+    return (int)tasks.size() < max_concurrency;
+}
+
 /**
  * @brief Gets the current request assigned to the server.
+ *
+ * Returns the request holding the CPU, else the oldest request in flight, else the
+ * most recently assigned request.
+ *
  * @return The current Request object.
  */
 Request WebServer::getCurrRequest()
 {
+    if (cpu_task >= 0)
+    {
+        return tasks[cpu_task].request;
+    }
+    if (!tasks.empty())
+    {
+        return tasks.front().request;
+    }
     return curr_request;
 }
 
@@ -73,3 +178,77 @@ int WebServer::getProcessedRequestCount()
 {
     return processed_count;
 }
+
+/**
+ * @brief Gets the requests that finished during the most recent tick.
+ * @return Requests completed by the last call to tick().
+ */
+const std::vector<Request> &WebServer::getCompletedRequests()
+{
+    return completed;
+}
+
+/**
+ * @brief Gets the number of requests currently in flight on this server.
+ * @return Number of assigned, unfinished requests.
+ */
+int WebServer::getActiveRequestCount()
+{
+    return tasks.size();
+}
+
+/**
+ * @brief Gets the number of cycles in which the server's CPU did work.
+ * @return Count of busy CPU cycles.
+ */
+int WebServer::getCpuBusyCycles()
+{
+    return cpu_busy_cycles;
+}
+
+/**
+ * @brief Gets the number of assigned requests that hit the server's cache.
+ * @return Cache hit count.
+ */
+int WebServer::getCacheHits()
+{
+    return cache.getHits();
+}
+
+/**
+ * @brief Gets the number of assigned requests that missed the server's cache.
+ * @return Cache miss count.
+ */
+int WebServer::getCacheMisses()
+{
+    return cache.getMisses();
+}
+
+/**
+ * @brief Checks whether a task's current stage is an I/O wait.
+ * @param task The task to inspect.
+ * @return True if the task is waiting on I/O.
+ */
+bool WebServer::inIO(const Task &task)
+{
+    return task.request.stages[task.stage].io;
+}
+
+/**
+ * @brief Moves a task past every finished stage, skipping zero-length ones.
+ * @param task The task whose current stage has run out.
+ * @return True if the task has no stages left.
+ */
+bool WebServer::advance(Task &task)
+{
+    while (task.remaining <= 0)
+    {
+        task.stage++;
+        if (task.stage >= task.request.stages.size())
+        {
+            return true;
+        }
+        task.remaining = task.request.stages[task.stage].cycles;
+    }
+    return false;
+}
@@ -4,23 +4,279 @@
  *
  * This program initializes the load balancer, creates a queue of initial requests,
  * and runs the simulation for a user-defined number of cycles.
+ * Alternatively, it sweeps a closed-loop client population over increasing sizes
+ * to compare goodput against offered load, compares server concurrency limits
+ * on requests that wait on backend I/O, compares cache-affinity routing with
+ * plain load spreading, or shows how rate limiting shields ordinary clients from
+ * a few noisy sources.
  * The simulation results are logged to a file in the docs directory.
  */
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "../headers/LoadBalancer.h"
+#include "../headers/ClientPopulation.h"
 #include "../headers/utility.h"
 
 using namespace std;
 
+/**
+ * @brief Runs one closed-loop simulation per client population size and summarizes goodput against offered load.
+ *
+ * Each run starts from a fresh load balancer with num_servers servers. Per-run logs are
+ * followed by a summary table with one row per population size.
+ *
+ * @param num_servers Initial number of web servers for every run.
+ * @param total_cycles Number of cycles to simulate per run.
+ * @param logfile Output stream to write simulation logs.
+ */
+void runClientSweep(int num_servers, int total_cycles, ostream &logfile)
+{
+    const int client_counts[] = {50, 100, 200, 400, 800, 1600, 3200};
+    double cycles = total_cycles + 1;
+    stringstream summary;
+
+    for (int num_clients : client_counts)
+    {
+        LoadBalancer lb(num_servers);
+        ClientPopulation clients(num_clients);
+
+        logfile << "=== Closed-loop run ===\n";
+        lb.simulateClosedLoop(total_cycles, clients, logfile);
+        logfile << "\n";
+
+        summary << num_clients << " | "
+                << clients.getSentCount() / cycles << " | "
+                << (clients.getGoodCount() + clients.getLateCount()) / cycles << " | "
+                << clients.getGoodCount() / cycles << " | "
+                << clients.getTimeoutCount() << " | "
+                << clients.getRetryCount() << " | "
+                << clients.getFailedCount() << "\n";
+    }
+
+    logfile << "Goodput vs Offered Load\n\n";
+    logfile << "Clients | Offered Load | Throughput | Goodput | Timeouts | Retries | Failed Requests\n";
+    logfile << "-----------------------------------------------------------------------------------\n";
+    logfile << summary.str();
+}
+
+/**
+ * @brief Runs the same multi-stage workload at several server concurrency limits and summarizes throughput.
+ *
+ * Each run uses a fixed pool of num_servers servers (no autoscaling), and the queue
+ * is topped up every cycle so every free slot can be filled, keeping servers
+ * saturated. A concurrency of 1 is the blocking one-request-per-server model; higher
+ * limits let servers overlap CPU work with other requests' I/O waits. Besides total
+ * throughput, the summary reports per-server throughput, CPU utilization, and the
+ * mean number of requests in flight per server.
+ *
+ * @param num_servers Number of web servers for every run.
+ * @param total_cycles Number of cycles to simulate per run.
+ * @param logfile Output stream to write simulation logs.
+ */
+void runConcurrencyComparison(int num_servers, int total_cycles, ostream &logfile)
+{
+    const int concurrency_limits[] = {1, 2, 4, 8};
+    double cycles = total_cycles + 1;
+
+    logfile << "Servers: " << num_servers << " (autoscaling disabled, queue kept full)\n";
+    logfile << "Stages for Task Times: CPU [2, 5], I/O [10, 29], CPU [2, 5]\n\n";
+    logfile << "Throughput vs Server Concurrency\n\n";
+    logfile << "Concurrency | Processed Requests | Throughput | Throughput per Server | CPU Utilization | Mean In-Flight per Server\n";
+    logfile << "-----------------------------------------------------------------------------------------------------------\n";
+
+    for (int concurrency : concurrency_limits)
+    {
+        LoadBalancerConfig config;
+        config.server_concurrency = concurrency;
+        LoadBalancer lb(num_servers, config);
+        int refill_target = num_servers * concurrency;
+        long long in_flight = 0;
+
+        for (int cycle = 0; cycle <= total_cycles; ++cycle)
+        {
+            while (lb.getQueueSize() < refill_target)
+            {
+                if (!lb.addRequest(generateRandomStagedRequest()))
+                {
+                    break;
+                }
+            }
+            lb.assignRequests();
+            in_flight += lb.getActiveRequestCount();
+            lb.tick();
+        }
+
+        double server_cycles = cycles * num_servers;
+        logfile << concurrency << " | "
+                << lb.getTotalProcessedRequests() << " | "
+                << lb.getTotalProcessedRequests() / cycles << " | "
+                << lb.getTotalProcessedRequests() / server_cycles << " | "
+                << lb.getCpuBusyCycles() / server_cycles << " | "
+                << in_flight / server_cycles << "\n";
+    }
+}
+
+/**
+ * @brief Runs the same workload with and without per-server caches and affinity routing, and summarizes hit rates and throughput.
+ *
+ * Servers cache content keys, and a hit halves the service time. Offered load
+ * alternates every PHASE_CYCLES between an overload phase of two requests per cycle,
+ * which saturates the pool even after autoscaling, and a light phase of one request
+ * every other cycle. Autoscaling therefore keeps growing and shrinking
+ * the pool. Because the overload phases keep servers saturated, throughput reflects
+ * how fast each routing policy serves requests. Server-cycles per completed request
+ * measures the capacity each policy spends per request.
+ *
+ * @param num_servers Initial number of web servers for every run.
+ * @param total_cycles Number of cycles to simulate per run.
+ * @param logfile Output stream to write simulation logs.
+ */
+void runCacheComparison(int num_servers, int total_cycles, ostream &logfile)
+{
+    const int PHASE_CYCLES = 2500;
+    const char *names[] = {"No cache", "Spread + cache", "Affinity + cache"};
+    const CacheConfig configs[] = {CacheConfig(), CacheConfig(64, 0.5, true), CacheConfig(64, 0.5, true)};
+    const bool affinity[] = {false, false, true};
+    double cycles = total_cycles + 1;
+
+    logfile << "Offered Load: 2 requests/cycle and 0.5 requests/cycle, alternating every " << PHASE_CYCLES << " cycles\n\n";
+    logfile << "Cache Affinity vs Load Spreading\n\n";
+    logfile << "Routing | Cache Hit Rate | Processed Requests | Throughput | Server-Cycles per Request | Rejected Requests | Final Servers\n";
+    logfile << "------------------------------------------------------------------------------------------------------------------\n";
+
+    for (int i = 0; i < 3; ++i)
+    {
+        LoadBalancerConfig config;
+        config.cache = configs[i];
+        config.affinity_routing = affinity[i];
+        LoadBalancer lb(num_servers, config);
+        long long server_cycles = 0;
+
+        for (int cycle = 0; cycle <= total_cycles; ++cycle)
+        {
+            lb.assignRequests();
+            lb.tick();
+            lb.scaleServers();
+            server_cycles += lb.getServerCount();
+
+            bool overload = (cycle / PHASE_CYCLES) % 2 == 0;
+            int arrivals = overload ? 2 : (rand() % 2);
+            for (int j = 0; j < arrivals; ++j)
+            {
+                lb.addRequest(generateRandomRequest());
+            }
+        }
+
+        int processed = lb.getTotalProcessedRequests();
+        logfile << names[i] << " | "
+                << lb.getCacheHitRate() << " | "
+                << processed << " | "
+                << processed / cycles << " | "
+                << (processed > 0 ? (double)server_cycles / processed : 0.0) << " | "
+                << lb.getRejectedRequests() << " | "
+                << lb.getServerCount() << "\n";
+    }
+}
+
+/**
+ * @brief Runs a workload with a few noisy sources with and without rate limiting, and compares who gets rejected.
+ *
+ * Besides the usual random-IP background traffic, NOISY_SOURCES fixed addresses each
+ * send one request every cycle. Together that is well above what the servers can
+ * process, so without rate limiting the queue fills and background requests are
+ * rejected along with the noisy ones.
+ *
+ * @param num_servers Initial number of web servers for every run.
+ * @param total_cycles Number of cycles to simulate per run.
+ * @param new_request_chance Percentage chance (0-100) of a background request each cycle.
+ * @param logfile Output stream to write simulation logs.
+ */
+void runNoisySourceComparison(int num_servers, int total_cycles, int new_request_chance, ostream &logfile)
+{
+    const int NOISY_SOURCES = 3;
+    vector<string> noisy_ips;
+    for (int i = 0; i < NOISY_SOURCES; ++i)
+    {
+        noisy_ips.push_back(generateRandomIP());
+    }
+
+    logfile << "Noisy Sources: " << NOISY_SOURCES << " sending 1 request/cycle each\n";
+    logfile << "Background Request Chance: " << new_request_chance << "%\n\n";
+    logfile << "Rate Limiting | Background Offered | Background Rejected | Noisy Offered | Noisy Admitted | Rejected Requests (Queue Full) | Rate Limited Requests | Processed Requests\n";
+    logfile << "-------------------------------------------------------------------------------------------------------------------------------------------------------------\n";
+
+    for (int limited = 0; limited <= 1; ++limited)
+    {
+        LoadBalancerConfig config;
+        if (!limited)
+        {
+            config.rate_limit = RateLimitConfig(0);
+        }
+        LoadBalancer lb(num_servers, config);
+        int background_offered = 0;
+        int background_rejected = 0;
+        int noisy_offered = 0;
+        int noisy_admitted = 0;
+
+        for (int cycle = 0; cycle <= total_cycles; ++cycle)
+        {
+            lb.assignRequests();
+            lb.tick();
+            lb.scaleServers();
+
+            if ((rand() % 100) < new_request_chance)
+            {
+                background_offered++;
+                if (!lb.addRequest(generateRandomRequest()))
+                {
+                    background_rejected++;
+                }
+            }
+
+            for (const string &ip : noisy_ips)
+            {
+                Request req = generateRandomRequest();
+                req.ip_in = ip;
+                noisy_offered++;
+                if (lb.addRequest(req))
+                {
+                    noisy_admitted++;
+                }
+            }
+        }
+
+        logfile << (limited ? "On" : "Off") << " | "
+                << background_offered << " | "
+                << background_rejected << " | "
+                << noisy_offered << " | "
+                << noisy_admitted << " | "
+                << lb.getRejectedRequests() << " | "
+                << lb.getRateLimitedRequests() << " | "
+                << lb.getTotalProcessedRequests() << "\n";
+
+        if (limited)
+        {
+            logfile << "\nTop Rate Limited Sources:\n";
+            for (const RateLimiter::Offender &offender : lb.getTopRateLimitedSources())
+            {
+                logfile << "  " << unpackIPv4(offender.ip) << " | " << offender.limited << "\n";
+            }
+        }
+    }
+}
+
 /**
  * @brief Main function that drives the Load Balancer simulation.
  *
- * - Prompts the user for the number of web servers and total simulation cycles.
- * - Initializes the load balancer and fills the request queue.
- * - Runs the simulation with a fixed chance of new requests per cycle.
- * - Logs the simulation output to docs/simulation_log.txt.
+ * - Prompts the user for the number of web servers, total simulation cycles, and mode.
+ * - Open-loop mode initializes the load balancer, fills the request queue, and runs the
+ *   simulation with a fixed chance of new requests per cycle, logging to docs/simulation_log.txt.
+ * - Closed-loop mode runs a client population sweep, logging to docs/client_sweep_log.txt.
+ * - Async I/O mode compares server concurrency limits, logging to docs/concurrency_log.txt.
+ * - Cache mode compares affinity routing with load spreading, logging to docs/cache_log.txt.
+ * - Noisy source mode compares runs with and without rate limiting, logging to docs/noisy_source_log.txt.
  *
  * @return int Returns 0 on successful execution, 1 if the log file cannot be opened.
  */
@@ -30,6 +286,7 @@ int main()
 
     int num_servers;
     int total_cycles;
+    int mode;
     int new_request_chance = 65; ///< Percentage chance (0-100) of a new request each cycle.
 
     cout << "Enter number of web servers: ";
@@ -38,7 +295,79 @@ int main()
     cout << "Enter total simulation clock cycles: ";
     cin >> total_cycles;
 
+    cout << "Select mode (1 = open-loop, 2 = closed-loop client sweep, 3 = async I/O comparison, 4 = cache affinity comparison, 5 = noisy source comparison): ";
+    cin >> mode;
+
+    if (mode == 2)
+    {
+        ofstream sweeplog("docs/client_sweep_log.txt");
+        if (!sweeplog)
+        {
+            cerr << "Error opening log file.\n";
+            return 1;
+        }
+
+        cout << "\nRunning closed-loop client sweep for " << total_cycles << " cycles per run...\n\n";
+        runClientSweep(num_servers, total_cycles, sweeplog);
+
+        cout << "Sweep complete. Log written to ../docs/client_sweep_log.txt\n";
+        sweeplog.close();
+        return 0;
+    }
+
+    if (mode == 3)
+    {
+        ofstream comparelog("docs/concurrency_log.txt");
+        if (!comparelog)
+        {
+            cerr << "Error opening log file.\n";
+            return 1;
+        }
+
+        cout << "\nRunning async I/O comparison for " << total_cycles << " cycles per run...\n\n";
+        runConcurrencyComparison(num_servers, total_cycles, comparelog);
+
+        cout << "Comparison complete. Log written to ../docs/concurrency_log.txt\n";
+        comparelog.close();
+        return 0;
+    }
+
+    if (mode == 4)
+    {
+        ofstream cachelog("docs/cache_log.txt");
+        if (!cachelog)
+        {
+            cerr << "Error opening log file.\n";
+            return 1;
+        }
+
+        cout << "\nRunning cache affinity comparison for " << total_cycles << " cycles per run...\n\n";
+        runCacheComparison(num_servers, total_cycles, cachelog);
+
+        cout << "Comparison complete. Log written to ../docs/cache_log.txt\n";
+        cachelog.close();
+        return 0;
+    }
+
+    if (mode == 5)
+    {
+        ofstream noisylog("docs/noisy_source_log.txt");
+        if (!noisylog)
+        {
+            cerr << "Error opening log file.\n";
+            return 1;
+        }
+
+        cout << "\nRunning noisy source comparison for " << total_cycles << " cycles per run...\n\n";
+        runNoisySourceComparison(num_servers, total_cycles, new_request_chance, noisylog);
+
+        cout << "Comparison complete. Log written to ../docs/noisy_source_log.txt\n";
+        noisylog.close();
+        return 0;
+    }
+
     LoadBalancer lb(num_servers);
+    lb.setSnapshotInterval(250);
 
     int initial_queue_size = num_servers * 100;
     for (int i = 0; i < initial_queue_size; ++i)
@@ -27,11 +27,29 @@ std::string generateRandomIP()
     return ss.str();
 }
 
+/**
+ * @brief Generates a random content key.
+ *
+ * 80% of keys come from the 200 most popular items and the rest from a catalog
+ * of 10000 items, so a cache holding the popular set sees most of the traffic.
+ *
+ * @return A content key in [0, 10000).
+ */
+uint32_t generateRandomContentKey()
+{
+    if ((rand() % 100) < 80)
+    {
+        return rand() % 200;
+    }
+    return rand() % 10000;
+}
+
 /**
  * @brief Generates a random Request object with random IP addresses and processing time.
  *
  * - Generates random inbound and outbound IP addresses.
  * - Sets the request time to a random value between 10 and 19 (inclusive).
+ * - Picks a random content key.
  *
  * @return A randomly generated Request object.
  */
@@ -40,5 +58,93 @@ Request generateRandomRequest()
     std::string ip_in = generateRandomIP();
     std::string ip_out = generateRandomIP();
     int time = (rand() % 10) + 10;
-    return Request(ip_in, ip_out, time);
+    Request req(ip_in, ip_out, time);
+    req.content_key = generateRandomContentKey();
+    return req;
+}
+
+/**
+ * @brief Generates a random Request that alternates CPU work and a backend I/O wait.
+ *
+ * - Generates random inbound and outbound IP addresses.
+ * - Adds a CPU stage of 2 to 5 cycles, an I/O stage of 10 to 29 cycles,
+ *   and a final CPU stage of 2 to 5 cycles.
+ * - Sets the request time to the total of its stages.
+ * - Picks a random content key.
+ *
+ * @return A randomly generated multi-stage Request object.
+ */
+Request generateRandomStagedRequest()
+{
+    Request req(generateRandomIP(), generateRandomIP(), 0);
+    RequestStage parse = {false, (rand() % 4) + 2};
+    RequestStage backend = {true, (rand() % 20) + 10};
+    RequestStage render = {false, (rand() % 4) + 2};
+    req.stages.push_back(parse);
+    req.stages.push_back(backend);
+    req.stages.push_back(render);
+    req.time = parse.cycles + backend.cycles + render.cycles;
+    req.content_key = generateRandomContentKey();
+    return req;
+}
+
+/**
+ * @brief Packs a dotted-quad IPv4 address into a 32-bit integer.
+ *
+ * Parses the four octets directly instead of going through a stringstream,
+ * since this runs on every admitted request.
+ *
+ * @param ip A string in the format "X.X.X.X".
+ * @return The packed address, or 0 if the string is malformed.
+ */
+uint32_t packIPv4(const std::string &ip)
+{
+    uint32_t packed = 0;
+    uint32_t octet = 0;
+    int digits = 0;
+    int dots = 0;
+
+    for (char c : ip)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            octet = octet * 10 + (c - '0');
+            if (++digits > 3 || octet > 255)
+            {
+                return 0;
+            }
+        }
+        else if (c == '.' && digits > 0 && dots < 3)
+        {
+            packed = (packed << 8) | octet;
+            octet = 0;
+            digits = 0;
+            dots++;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    if (dots != 3 || digits == 0)
+    {
+        return 0;
+    }
+    return (packed << 8) | octet;
+}
+
+/**
+ * @brief Formats a packed 32-bit IPv4 address as a dotted-quad string.
+ * @param ip The packed address.
+ * @return The address in "X.X.X.X" format.
+ */
+std::string unpackIPv4(uint32_t ip)
+{
+    std::stringstream ss;
+    ss << ((ip >> 24) & 0xFF) << "."
+       << ((ip >> 16) & 0xFF) << "."
+       << ((ip >> 8) & 0xFF) << "."
+       << (ip & 0xFF);
+    return ss.str();
 }